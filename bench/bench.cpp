@@ -0,0 +1,280 @@
+#include <hdaq.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+/// Benchmark of the insert path.
+///
+/// Every case writes records of one element type and size into a fresh file
+/// and reports the sustained throughput together with the latency
+/// percentiles of the individual `insert` calls. Results are printed as JSON
+/// or CSV, and can be checked against a baseline with `bench/compare.py`.
+///
+/// usage: hdf5daq_bench [--records N] [--bytes B] [--dir PATH]...
+///                      [--format json|csv] [--output FILE] [--quick]
+
+/* ------------------------------------------------------------------------- */
+
+/// Parameters of a single benchmark case.
+struct bench_case {
+  std::string type;    ///< Element type name.
+  size_t elements;     ///< Elements per record.
+  size_t datasets;     ///< Datasets written round-robin.
+  std::string mode;    ///< `append` to existing or `create` new datasets.
+  std::string options; ///< `default`, `buffered`, `deflate` or
+                       ///< `buffered+deflate`.
+  size_t chunk;        ///< Target chunk size in bytes.
+  std::string dir;     ///< Directory of the file.
+  size_t records;      ///< Total number of inserts.
+};
+
+/// Measurements of a single benchmark case.
+struct bench_result {
+  double seconds;      ///< Wall-clock time including the final flush.
+  double records_s;    ///< Records per second.
+  double mb_s;         ///< Megabytes of record data per second.
+  double p50;          ///< Median insert latency, in microseconds.
+  double p90;          ///< 90th percentile insert latency, in microseconds.
+  double p99;          ///< 99th percentile insert latency, in microseconds.
+  double max;          ///< Maximum insert latency, in microseconds.
+};
+
+/* ------------------------------------------------------------------------- */
+
+/// Latency at quantile `q` of sorted samples.
+double percentile(const std::vector<double>& sorted, const double q) {
+  if (sorted.empty()) return 0;
+  const size_t i = static_cast<size_t>(q * (sorted.size() - 1) + 0.5);
+  return sorted[std::min(i, sorted.size() - 1)];
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+bench_result run(const bench_case& c) {
+
+  typedef std::chrono::steady_clock clock;
+
+  const bool buffered = c.options.find("buffered") != std::string::npos;
+  hdaq::dataset_options opts;
+  opts.chunk_bytes = c.chunk;
+  if (c.options.find("deflate") != std::string::npos) {
+    opts.shuffle = true;
+    opts.deflate = 1;
+  }
+
+  std::vector<std::string> names(c.mode == "create"? c.records : c.datasets);
+  for (size_t i = 0; i < names.size(); i++) {
+    names[i] = "dataset" + std::to_string(i);
+  }
+
+  std::vector<T> data(c.elements);
+  for (size_t i = 0; i < data.size(); i++) data[i] = static_cast<T>(i % 127);
+  const hdaq::view<T> record(data);
+
+  std::vector<double> latency(c.records);
+  std::string fname;
+  const clock::time_point start = clock::now();
+  {
+    class hdaq::interface interface(c.dir + "/hdaq_bench");
+    fname = interface.filename();
+    if (buffered) interface.set_buffer(256, 1 << 20);
+
+    for (size_t i = 0; i < c.records; i++) {
+      data[0] = static_cast<T>(i);
+      const clock::time_point t0 = clock::now();
+      interface.insert(record, names[i % names.size()], opts);
+      const std::chrono::duration<double, std::micro> dt = clock::now() - t0;
+      latency[i] = dt.count();
+    }
+    interface.flush();
+  }
+  const std::chrono::duration<double> elapsed = clock::now() - start;
+  std::remove(fname.c_str());
+
+  std::sort(latency.begin(), latency.end());
+  bench_result r;
+  r.seconds = elapsed.count();
+  r.records_s = c.records / r.seconds;
+  r.mb_s = r.records_s * c.elements * sizeof(T) / 1e6;
+  r.p50 = percentile(latency, 0.50);
+  r.p90 = percentile(latency, 0.90);
+  r.p99 = percentile(latency, 0.99);
+  r.max = latency.empty()? 0 : latency.back();
+  return r;
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+bench_result run(const bench_case& c) {
+  if (c.type == "uint16") return run<uint16_t>(c);
+  if (c.type == "int32") return run<int32_t>(c);
+  if (c.type == "float") return run<float>(c);
+  return run<double>(c);
+}
+
+/* ------------------------------------------------------------------------- */
+
+size_t type_size(const std::string& type) {
+  if (type == "uint16") return sizeof(uint16_t);
+  if (type == "int32") return sizeof(int32_t);
+  if (type == "float") return sizeof(float);
+  return sizeof(double);
+}
+
+/* ------------------------------------------------------------------------- */
+
+/// Identifier of a case, used to match results against a baseline.
+std::string case_id(const bench_case& c) {
+  std::ostringstream id;
+  id << c.mode << "/" << c.type << "/" << c.elements << "/" << c.datasets
+     << "/" << c.options << "/" << c.chunk << "/" << c.dir;
+  return id.str();
+}
+
+/* ------------------------------------------------------------------------- */
+
+void print_json(
+  std::ostream& out,
+  const std::vector<bench_case>& cases,
+  const std::vector<bench_result>& results
+) {
+  out << "[\n";
+  for (size_t i = 0; i < cases.size(); i++) {
+    const bench_case& c = cases[i];
+    const bench_result& r = results[i];
+    out << "  {\"id\": \"" << case_id(c) << "\", \"mode\": \"" << c.mode
+        << "\", \"type\": \"" << c.type << "\", \"elements\": " << c.elements
+        << ", \"record_bytes\": " << c.elements * type_size(c.type)
+        << ", \"datasets\": " << c.datasets << ", \"options\": \""
+        << c.options << "\", \"chunk_bytes\": " << c.chunk
+        << ", \"dir\": \"" << c.dir << "\", \"records\": "
+        << c.records << ", \"seconds\": " << r.seconds
+        << ", \"records_per_s\": " << r.records_s << ", \"mb_per_s\": "
+        << r.mb_s << ", \"latency_us\": {\"p50\": " << r.p50 << ", \"p90\": "
+        << r.p90 << ", \"p99\": " << r.p99 << ", \"max\": " << r.max << "}}"
+        << (i + 1 < cases.size()? ",\n" : "\n");
+  }
+  out << "]\n";
+}
+
+/* ------------------------------------------------------------------------- */
+
+void print_csv(
+  std::ostream& out,
+  const std::vector<bench_case>& cases,
+  const std::vector<bench_result>& results
+) {
+  out << "id,mode,type,elements,record_bytes,datasets,options,chunk_bytes,"
+         "dir,records,seconds,records_per_s,mb_per_s,p50_us,p90_us,p99_us,"
+         "max_us\n";
+  for (size_t i = 0; i < cases.size(); i++) {
+    const bench_case& c = cases[i];
+    const bench_result& r = results[i];
+    out << case_id(c) << "," << c.mode << "," << c.type << "," << c.elements
+        << "," << c.elements * type_size(c.type) << "," << c.datasets << ","
+        << c.options << "," << c.chunk << "," << c.dir << "," << c.records
+        << "," << r.seconds
+        << "," << r.records_s << "," << r.mb_s << "," << r.p50 << ","
+        << r.p90 << "," << r.p99 << "," << r.max << "\n";
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+
+int main(int argc, char** argv) {
+
+  size_t records = 20000;
+  size_t budget = 64 << 20;
+  std::vector<std::string> dirs;
+  std::string format = "json";
+  std::string output;
+  bool quick = false;
+
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    const bool value = i + 1 < argc;
+    if (arg == "--records" && value) records = std::stoul(argv[++i]);
+    else if (arg == "--bytes" && value) budget = std::stoul(argv[++i]);
+    else if (arg == "--dir" && value) dirs.push_back(argv[++i]);
+    else if (arg == "--format" && value) format = argv[++i];
+    else if (arg == "--output" && value) output = argv[++i];
+    else if (arg == "--quick") quick = true;
+    else {
+      std::cerr << "usage: " << argv[0] << " [--records N] [--bytes B]"
+                << " [--dir PATH]... [--format json|csv] [--output FILE]"
+                << " [--quick]\n";
+      return 1;
+    }
+  }
+
+  /// by default compare tmpfs, where available, against the working directory
+  if (dirs.empty()) {
+    std::ofstream probe("/dev/shm/hdaq_bench_probe");
+    if (probe.is_open()) {
+      probe.close();
+      std::remove("/dev/shm/hdaq_bench_probe");
+      dirs.push_back("/dev/shm");
+    }
+    dirs.push_back(".");
+  }
+
+  const std::vector<std::string> types = quick?
+    std::vector<std::string>{"double"} :
+    std::vector<std::string>{"uint16", "int32", "float", "double"};
+  const std::vector<size_t> sizes = quick?
+    std::vector<size_t>{64, 4096} : std::vector<size_t>{16, 256, 4096, 65536};
+  const std::vector<std::string> options{
+    "default", "buffered", "deflate", "buffered+deflate"
+  };
+  const size_t chunk = hdaq::dataset_options().chunk_bytes;
+  const std::vector<size_t> chunks = quick?
+    std::vector<size_t>{chunk} :
+    std::vector<size_t>{64 << 10, chunk, 4 << 20};
+
+  /// each case writes at most `budget` bytes and stages at most `budget`
+  /// bytes, and creates at most 1000 datasets; chunk sizes are varied for
+  /// a single appended dataset only, to keep the matrix small
+  std::vector<bench_case> cases;
+  for (const std::string& dir : dirs) {
+    for (const std::string& type : types) {
+      for (const size_t elements : sizes) {
+        const size_t bytes = elements * type_size(type);
+        const size_t n = std::max<size_t>(1, std::min(records, budget / bytes));
+        for (const std::string& opt : options) {
+          for (const size_t c : chunks) {
+            cases.push_back(
+              bench_case{type, elements, 1, "append", opt, c, dir, n}
+            );
+          }
+          cases.push_back(
+            bench_case{type, elements, 16, "append", opt, chunk, dir, n}
+          );
+          const size_t stage = std::min<size_t>(256 * bytes, 1 << 20);
+          const size_t nc = std::max<size_t>(
+            1, std::min<size_t>(std::min<size_t>(n, 1000), budget / stage)
+          );
+          cases.push_back(
+            bench_case{type, elements, nc, "create", opt, chunk, dir, nc}
+          );
+        }
+      }
+    }
+  }
+
+  std::vector<bench_result> results;
+  for (const bench_case& c : cases) {
+    results.push_back(run(c));
+    std::cerr << case_id(c) << ": " << results.back().mb_s << " MB/s\n";
+  }
+
+  std::ofstream file;
+  if (!output.empty()) file.open(output);
+  std::ostream& out = output.empty()? std::cout : file;
+  if (format == "csv") print_csv(out, cases, results);
+  else print_json(out, cases, results);
+
+  return 0;
+}
@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+"""Compares hdf5daq_bench results against a baseline.
+
+usage: compare.py BASELINE CURRENT [--threshold 0.10] [--latency 0.50]
+
+Both files are the JSON or CSV output of hdf5daq_bench. Cases are matched by
+id. A case regresses when its throughput drops by more than `--threshold` or
+its p99 insert latency grows by more than `--latency`, both relative to the
+baseline. A case of the baseline that is missing from the current results
+also counts as a regression. The exit status is 1 when any case regresses,
+so the script can gate a CI job.
+"""
+
+import argparse
+import csv
+import json
+import sys
+
+
+def load(path):
+    """Returns {id: (records_per_s, p99_us)} for a result file."""
+    with open(path) as fp:
+        if path.endswith(".csv"):
+            rows = list(csv.DictReader(fp))
+            return {
+                r["id"]: (float(r["records_per_s"]), float(r["p99_us"]))
+                for r in rows
+            }
+        rows = json.load(fp)
+        return {
+            r["id"]: (float(r["records_per_s"]), float(r["latency_us"]["p99"]))
+            for r in rows
+        }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="tolerated relative throughput drop")
+    parser.add_argument("--latency", type=float, default=0.50,
+                        help="tolerated relative p99 latency increase")
+    args = parser.parse_args()
+
+    base = load(args.baseline)
+    cur = load(args.current)
+
+    regressions = 0
+    print("%-50s %12s %12s %8s %8s" % ("case", "base rec/s", "rec/s", "speed", "p99"))
+    for key in sorted(base):
+        if key not in cur:
+            regressions += 1
+            print("%-50s missing from current results  REGRESSION" % key)
+            continue
+        (brate, bp99), (rate, p99) = base[key], cur[key]
+        speed = rate / brate if brate else 1.0
+        lat = p99 / bp99 if bp99 else 1.0
+        bad = speed < 1.0 - args.threshold or lat > 1.0 + args.latency
+        regressions += bad
+        print("%-50s %12.0f %12.0f %7.2fx %7.2fx%s" % (
+            key, brate, rate, speed, lat, "  REGRESSION" if bad else ""))
+
+    for key in sorted(set(cur) - set(base)):
+        print("%-50s new case" % key)
+
+    print("%d of %d cases regressed" % (regressions, len(base)))
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,5 +1,7 @@
 option(ENABLE_BUILD_EXAMPLE "build the example binary"                    OFF )
 option(ENABLE_BUILD_LIBRARY "build the library"                           ON )
 option(ENABLE_BUILD_TEST    "build the tests"                             OFF )
+option(ENABLE_BUILD_BENCHMARK "build the benchmark binary"                OFF )
+option(ENABLE_STATS         "collect insert-path statistics"              OFF )
 option(ENABLE_BINARY_FOLDER "Dump all binaries to bin/"                   OFF )
 option(ENABLE_DEBUG         "Set build type to debug"                     OFF )
@@ -1,7 +1,11 @@
 
 # tests dependency
 if (ENABLE_BUILD_TEST)
-  add_subdirectory(extern/catch2)
+  if (EXISTS ${CMAKE_CURRENT_SOURCE_DIR}/extern/catch2/CMakeLists.txt)
+    add_subdirectory(extern/catch2)
+  else()
+    find_package(Catch2 2 REQUIRED)
+  endif()
 endif()
 
 # hdf5 library
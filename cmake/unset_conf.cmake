@@ -1,6 +1,8 @@
 unset(ENABLE_BUILD_EXAMPLE CACHE)
 unset(ENABLE_BUILD_LIBRARY CACHE)
 unset(ENABLE_BUILD_TEST    CACHE)
+unset(ENABLE_BUILD_BENCHMARK CACHE)
+unset(ENABLE_STATS CACHE)
 unset(ENABLE_BINARY_FOLDER CACHE)
 unset(ENABLE_DEBUG CACHE)
 unset(CMAKE_BUILD_TYPE CACHE)
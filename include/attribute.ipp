@@ -12,6 +12,18 @@ hdaq::attribute<T>::attribute(const std::string& n, const size_t size) :
 
 //////////////////////////////////////////////////////////////////////////////
 
+template <typename T>
+hdaq::attribute<T>::attribute(const std::string& n, const std::vector<T>& vec) :
+  std::vector<T>(vec), attr_name(n) {}
+
+//////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+hdaq::attribute<T>::attribute(const std::string& n, std::vector<T>&& vec) :
+  std::vector<T>(std::move(vec)), attr_name(n) {}
+
+//////////////////////////////////////////////////////////////////////////////
+
 template <typename T>
 hdaq::attribute<T>::attribute(
   const std::string& n,
@@ -32,6 +44,17 @@ hdaq::attribute<T>::operator=(const std::vector<T>& other) {
 
 //////////////////////////////////////////////////////////////////////////////
 
+template <typename T>
+hdaq::attribute<T>& 
+hdaq::attribute<T>::operator=(std::vector<T>&& other) {
+  if (this != &other) {
+    std::vector<T>::operator=(std::move(other));
+  }
+  return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 template <typename T>
 hdaq::attribute<T>& 
 hdaq::attribute<T>::operator=(const T other) {
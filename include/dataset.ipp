@@ -18,6 +18,12 @@ hdaq::dataset<T>::dataset(const std::vector<T>& vec) :
 
 ///////////////////////////////////////////////////////////////////////////////
 
+template <typename T>
+hdaq::dataset<T>::dataset(std::vector<T>&& vec) : 
+  std::vector<T>(std::move(vec)) {}
+
+///////////////////////////////////////////////////////////////////////////////
+
 template <typename T>
 hdaq::dataset<T>::dataset(const std::initializer_list<T> ilist) :
   std::vector<T>(ilist) {}
@@ -35,6 +41,17 @@ hdaq::dataset<T>::operator=(const std::vector<T>& other) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+template <typename T>
+hdaq::dataset<T>&
+hdaq::dataset<T>::operator=(std::vector<T>&& other) {
+  if (this != &other) {
+    std::vector<T>::operator=(std::move(other));
+  }
+  return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 template <typename T> 
 hdaq::dataset<T>&
 hdaq::dataset<T>::operator=(const T other) {
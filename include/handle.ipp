@@ -0,0 +1,28 @@
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+hdaq::handle<T>::handle() :
+  owner(nullptr), generation(0), info(nullptr) {}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+hdaq::handle<T>::handle(const interface* owner, interface::dset_info* info) :
+  owner(owner), generation(owner->generation), info(info) {}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+bool
+hdaq::handle<T>::valid() const {
+  return info != nullptr && owner->generation == generation;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+hdaq::handle<T>::operator const H5::DataSet&() const {
+  return info->dset;
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -76,12 +76,45 @@ HDF5 Examples
 #include <array>
 #include <utility>
 #include <map>
+#include <unordered_map>
 #include <fstream>
+#include <string>
+#include <limits>
+#include <stdexcept>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <cstdint>
+#include <chrono>
+#include <future>
+#include <complex>
+#include <type_traits>
+#include <typeinfo>
+#include <cstring>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <memory>
 
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <H5Cpp.h>
 
+///////////////////////////////////////////////////////////////////////////////
+
+/// Instrumentation of the insert path, compiled in with HDAQ_ENABLE_STATS.
+#ifdef HDAQ_ENABLE_STATS
+#define HDAQ_STATS(...) __VA_ARGS__
+#else
+#define HDAQ_STATS(...)
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 namespace hdaq {
   /**
@@ -123,6 +156,14 @@ namespace hdaq {
        */
       attribute(const std::string& n, const std::vector<T>& vec);
 
+      /**
+       * @brief Constructs an attribute by taking over the storage of an
+       * existing std::vector, with a specified name.
+       * @param n Name of the attribute.
+       * @param vec A vector object whose storage is moved into the attribute.
+       */
+      attribute(const std::string& n, std::vector<T>&& vec);
+
       /**
        * @brief Constructs an attribute from an initializer list, with a
        * specified name.
@@ -130,6 +171,11 @@ namespace hdaq {
        * @param ilist An initializer list to initialize the attribute.
        */
       attribute(const std::string& n, const std::initializer_list<T> ilist);
+
+      attribute(const attribute<T>&) = default;
+      attribute(attribute<T>&&) = default;
+      attribute<T>& operator=(const attribute<T>&) = default;
+      attribute<T>& operator=(attribute<T>&&) = default;
       
       /**
        * @brief Assigns the values of an existing std::vector to this
@@ -140,6 +186,15 @@ namespace hdaq {
        */
       attribute<T>& operator=(const std::vector<T>& other);
 
+      /**
+       * @brief Moves the storage of an existing std::vector into this
+       * attribute.
+       * @param other A vector object whose storage is moved into this
+       * attribute.
+       * @return Reference to this attribute after assignment.
+       */
+      attribute<T>& operator=(std::vector<T>&& other);
+
       /**
        * @brief Assigns a single value to all elements in the attribute.
        * @param other The value to assign to all elements of the attribute.
@@ -154,7 +209,7 @@ namespace hdaq {
       const std::string name() const;
 
     private:
-      const std::string attr_name; ///< Name of the attribute.
+      std::string attr_name; ///< Name of the attribute.
   };
 }
 #include <attribute.ipp>
@@ -195,12 +250,24 @@ namespace hdaq {
        */
       dataset(const std::vector<T>& vec);
 
+      /**
+       * @brief Constructs a dataset by taking over the storage of an existing
+       * std::vector.
+       * @param vec A vector object whose storage is moved into the dataset.
+       */
+      dataset(std::vector<T>&& vec);
+
       /**
        * @brief Constructs a dataset from an initializer list.
        * @param ilist An initializer list to initialize the dataset.
        */
       dataset(const std::initializer_list<T> ilist);
 
+      dataset(const dataset<T>&) = default;
+      dataset(dataset<T>&&) = default;
+      dataset<T>& operator=(const dataset<T>&) = default;
+      dataset<T>& operator=(dataset<T>&&) = default;
+
       /**
        * @brief Assigns the values of an existing std::vector to this dataset.
        * @param other A vector object whose values are to be assigned to this
@@ -209,6 +276,15 @@ namespace hdaq {
        */
       dataset<T>& operator=(const std::vector<T>& other);
 
+      /**
+       * @brief Moves the storage of an existing std::vector into this
+       * dataset.
+       * @param other A vector object whose storage is moved into this
+       * dataset.
+       * @return Reference to this dataset after assignment.
+       */
+      dataset<T>& operator=(std::vector<T>&& other);
+
       /**
        * @brief Assigns a single value to all elements in the dataset.
        * @param other The value to assign to all elements of the dataset.
@@ -222,6 +298,531 @@ namespace hdaq {
 ///////////////////////////////////////////////////////////////////////////////
 
 namespace hdaq {
+  /**
+   * @class view
+   * @brief Non-owning view of a record in caller-owned memory.
+   *
+   * A view refers to `size` elements starting at `data`, spaced `stride`
+   * elements apart. Inserting a view writes directly from the referenced
+   * memory, such as a DMA or driver buffer, without copying it into a
+   * `dataset` first. The memory must stay valid for the duration of the
+   * insert call.
+   *
+   * @tparam T Data type of the elements.
+   */
+  template <typename T>
+  class view {
+    public:
+      /**
+       * @brief Constructs a view of a contiguous or strided block of memory.
+       * @param data Pointer to the first element.
+       * @param size Number of elements.
+       * @param stride Distance between consecutive elements, in elements.
+       */
+      view(const T* data, const size_t size, const size_t stride = 1);
+
+      /**
+       * @brief Constructs a view of the contents of a std::vector.
+       * @param vec Vector to view.
+       */
+      explicit view(const std::vector<T>& vec);
+
+      /**
+       * @brief Pointer to the first element.
+       */
+      const T* data() const;
+
+      /**
+       * @brief Number of elements.
+       */
+      size_t size() const;
+
+      /**
+       * @brief Distance between consecutive elements, in elements.
+       */
+      size_t stride() const;
+
+      /**
+       * @brief Accesses the i-th element of the view.
+       * @param i Index of the element.
+       * @return Reference to the element.
+       */
+      const T& operator[](const size_t i) const;
+
+    private:
+      const T* ptr; ///< Pointer to the first element.
+      size_t len;   ///< Number of elements.
+      size_t step;  ///< Distance between consecutive elements.
+  };
+}
+#include <view.ipp>
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace hdaq {
+  /**
+   * @struct h5type
+   * @brief Maps a C++ type to its HDF5 memory type at compile time.
+   *
+   * Specialisations provide a static `get()` returning the HDF5 data type,
+   * which is resolved once and cached. All fundamental arithmetic types,
+   * `std::complex`, `fixed_string`, enumerations (as their underlying integer
+   * type), C arrays and `std::array` of supported types are mapped. Using any
+   * other type fails to compile; structures can be registered as compound
+   * types by specialising `h5type` and deriving from `compound_type`.
+   *
+   * @code
+   * struct event { double time; int16_t adc[8]; uint8_t flags; };
+   *
+   * template <>
+   * struct hdaq::h5type<event> : hdaq::compound_type<event> {
+   *   static void describe(hdaq::compound<event>& c) {
+   *     c.insert("time", &event::time)
+   *      .insert("adc", &event::adc)
+   *      .insert("flags", &event::flags);
+   *   }
+   * };
+   * @endcode
+   *
+   * @tparam T C++ data type.
+   */
+  template <typename T, typename Enable = void>
+  struct h5type {
+    static_assert(sizeof(T) == 0,
+      "unsupported data type, specialise hdaq::h5type for it");
+  };
+
+  /**
+   * @class fixed_string
+   * @brief Fixed-length, null padded string of at most N characters.
+   * @tparam N Length of the string in bytes.
+   */
+  template <size_t N>
+  class fixed_string {
+    public:
+      /**
+       * @brief Constructs an empty string.
+       */
+      fixed_string();
+
+      /**
+       * @brief Constructs a string from a std::string, truncated to N
+       * characters.
+       * @param str String to copy.
+       */
+      fixed_string(const std::string& str);
+
+      /**
+       * @brief Constructs a string from a C string, truncated to N
+       * characters.
+       * @param str String to copy.
+       */
+      fixed_string(const char* str);
+
+      /**
+       * @brief Converts the string to a std::string.
+       */
+      std::string str() const;
+
+    private:
+      char buf[N]; ///< Characters, padded with null bytes.
+  };
+
+  /**
+   * @class compound
+   * @brief Builds the HDF5 compound type of a trivially copyable structure.
+   * @tparam S Structure type.
+   */
+  template <typename S>
+  class compound {
+    public:
+      /**
+       * @brief Starts an empty compound type of the size of S.
+       */
+      compound();
+
+      /**
+       * @brief Adds a member of the structure as a field.
+       * @param name Name of the field.
+       * @param member Pointer to the member.
+       * @return Reference to this builder.
+       * @tparam M Type of the member, which must itself be mapped.
+       */
+      template <typename M>
+      compound<S>& insert(const std::string& name, M S::* member);
+
+      /**
+       * @brief Built compound type.
+       */
+      const H5::CompType& type() const;
+
+    private:
+      H5::CompType ctype; ///< Compound type under construction.
+  };
+
+  /**
+   * @struct compound_type
+   * @brief Base for `h5type` specialisations of compound structures.
+   *
+   * The derived specialisation provides `static void describe(compound<S>&)`
+   * listing the fields; the resulting type is built once on first use.
+   * @tparam S Structure type.
+   */
+  template <typename S>
+  struct compound_type {
+    static const H5::DataType& get();
+  };
+
+  /**
+   * @class enumeration
+   * @brief Builds a named HDF5 enumeration type for an enum.
+   *
+   * Enums are mapped to their underlying integer type by default. To store
+   * the names of the values as well, specialise `h5type` with a `get()`
+   * returning a type built with this class.
+   * @tparam E Enumeration type.
+   */
+  template <typename E>
+  class enumeration {
+    public:
+      /**
+       * @brief Starts an empty enumeration based on the underlying type of E.
+       */
+      enumeration();
+
+      /**
+       * @brief Adds a named value.
+       * @param name Name of the value.
+       * @param value Value.
+       * @return Reference to this builder.
+       */
+      enumeration<E>& insert(const std::string& name, const E value);
+
+      /**
+       * @brief Built enumeration type.
+       */
+      const H5::EnumType& type() const;
+
+    private:
+      H5::EnumType etype; ///< Enumeration type under construction.
+  };
+}
+#include <types.ipp>
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace hdaq {
+  /**
+   * @brief Orientation of the records of a dataset within the file.
+   */
+  enum class layout {
+    channel_major, ///< Dimensions {size, records}, one column per record.
+    record_major   ///< Dimensions {records, size}, one row per record.
+  };
+
+  /**
+   * @brief Identifiers of registered third party compression filters.
+   */
+  namespace filter {
+    const H5Z_filter_t lz4  = 32004; ///< LZ4 filter.
+    const H5Z_filter_t zstd = 32015; ///< Zstandard filter.
+  }
+
+  /**
+   * @struct dataset_options
+   * @brief Creation options of a dataset.
+   *
+   * Controls the layout, chunking and filter pipeline used when a dataset is
+   * created. Options have no effect on datasets that already exist.
+   */
+  struct dataset_options {
+    /// Orientation of the records within the file.
+    hdaq::layout layout = hdaq::layout::channel_major;
+
+    /// Number of records per chunk. Zero derives it from `chunk_bytes` and
+    /// `expected_records`.
+    size_t chunk_records = 0;
+
+    /// Targeted chunk size in bytes when `chunk_records` is zero. HDF5
+    /// allocates whole chunks, so an unfiltered dataset takes at least one
+    /// chunk on disk however few records it holds.
+    size_t chunk_bytes = 512 * 1024;
+
+    /// Expected number of records. When nonzero, a chunk derived from
+    /// `chunk_bytes` holds at most this many records, so that small datasets
+    /// do not allocate a full chunk. Zero means unknown.
+    size_t expected_records = 0;
+
+    /// Enables the byte shuffle filter.
+    bool shuffle = false;
+
+    /// Deflate compression level from 1 to 9. Zero disables deflate.
+    unsigned int deflate = 0;
+
+    /// Registered filter, such as `filter::lz4`. Zero disables it. The
+    /// filter is skipped if it is not available at runtime.
+    H5Z_filter_t filter = 0;
+
+    /// Client data values passed to `filter`.
+    std::vector<unsigned int> filter_values;
+  };
+
+  /**
+   * @brief Naming scheme of the files created by a rollover.
+   */
+  enum class naming {
+    sequence, ///< `name_000001.h5`, `name_000002.h5`, ...
+    timestamp ///< `name_20240101T120000.h5`, in UTC.
+  };
+
+  /**
+   * @struct rollover_options
+   * @brief Policy for switching to a new file during acquisition.
+   *
+   * The interface switches to a new file once any enabled limit is reached.
+   * The next file, with all datasets of the current file replicated, is
+   * prepared when a fraction `prepare_at` of a limit is reached, so the
+   * switch itself only closes one file and adopts the other. Preparation
+   * runs on a background thread when HDF5 is built thread-safe, and
+   * synchronously at `prepare_at` otherwise.
+   */
+  struct rollover_options {
+    /// Bytes of record data per file. Zero disables the limit.
+    size_t max_bytes = 0;
+
+    /// Records, summed over all datasets, per file. Zero disables the limit.
+    size_t max_records = 0;
+
+    /// Wall-clock time per file. Zero disables the limit.
+    std::chrono::milliseconds interval = std::chrono::milliseconds(0);
+
+    /// Naming scheme of the new files.
+    hdaq::naming naming = hdaq::naming::sequence;
+
+    /// Fraction of a limit at which the next file is prepared.
+    double prepare_at = 0.9;
+  };
+
+  /**
+   * @struct swmr_options
+   * @brief Cadence at which records become visible to SWMR readers.
+   *
+   * A dataset is flushed, staged records included, once either limit is
+   * reached since its previous flush. Shorter cadences lower the latency of
+   * live readers at the cost of more, smaller writes.
+   */
+  struct swmr_options {
+    /// Records appended to a dataset between flushes. Zero disables the limit.
+    size_t flush_records = 0;
+
+    /// Time between flushes of a dataset. Zero disables the limit.
+    std::chrono::milliseconds interval = std::chrono::milliseconds(100);
+  };
+
+  /**
+   * @struct checkpoint_options
+   * @brief Cadence of durable checkpoints.
+   *
+   * A checkpoint writes all staged records, records the extent of every
+   * dataset in its `hdaq_checkpoint` attribute and flushes the file, so a
+   * crash loses at most the records since the last checkpoint. Its cost is
+   * one metadata flush per checkpoint, bounded by these limits.
+   */
+  struct checkpoint_options {
+    /// Records, summed over all datasets, between checkpoints. Zero disables
+    /// the limit.
+    size_t records = 0;
+
+    /// Time between checkpoints. Zero disables the limit.
+    std::chrono::milliseconds interval = std::chrono::milliseconds(0);
+  };
+
+  /**
+   * @struct reduction_options
+   * @brief Overviews of a dataset computed while it is written.
+   *
+   * Every `decimate`-th record is copied to `<name>_every_<N>`. For each
+   * level of `F` records, the element-wise minimum, maximum, mean and RMS of
+   * each block of `F` consecutive records are written as one record to
+   * `<name>_min_<F>`, `<name>_max_<F>`, `<name>_mean_<F>` and
+   * `<name>_rms_<F>`. Coarser levels are computed from finer ones, so the
+   * raw records are only traversed once. Record `k` of a level covers raw
+   * records `[kF, (k+1)F)`; a trailing incomplete block is not written, and
+   * when `set_filename` resumes the dataset, the records of open blocks are
+   * read back so that they complete. Raw records are counted per file: after
+   * a rollover, blocks and decimation start again at the first record of the
+   * new file, and the open blocks of the closed file are not written.
+   */
+  struct reduction_options {
+    /// Keeps every Nth record. Zero disables decimation.
+    size_t decimate = 0;
+
+    /// Block sizes in records, increasing, each a multiple of the previous.
+    std::vector<size_t> levels;
+  };
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace hdaq {
+  /**
+   * @brief Low-level driver performing the file I/O.
+   */
+  enum class driver {
+    sec2,   ///< Default POSIX driver.
+    core,   ///< In memory, optionally written to disk when the file closes.
+    direct  ///< POSIX with `O_DIRECT`, bypassing the page cache.
+  };
+
+  /**
+   * @struct file_options
+   * @brief File creation and access properties of the files of an interface.
+   *
+   * Defaults leave HDF5's own defaults in place. For large appends, aligning
+   * chunks to the filesystem block or stripe and aggregating metadata into
+   * larger blocks turns scattered small writes into aligned, coalesced ones.
+   */
+  struct file_options {
+    /// Raw-data chunk cache per dataset, in bytes. Zero keeps 1 MiB.
+    size_t chunk_cache_bytes = 0;
+
+    /// Hash slots of the chunk cache, ideally a prime around 100 times the
+    /// number of chunks in the cache. Zero keeps 521.
+    size_t chunk_cache_slots = 0;
+
+    /// Preemption policy of fully read or written chunks, between 0 and 1.
+    /// Negative keeps 0.75.
+    double chunk_cache_w0 = -1;
+
+    /// Alignment of file objects in bytes, such as the filesystem block or
+    /// stripe size. Zero disables alignment.
+    hsize_t alignment = 0;
+
+    /// Objects smaller than this size in bytes are not aligned.
+    hsize_t alignment_threshold = 64 * 1024;
+
+    /// Size of the blocks metadata is aggregated into. Zero keeps 2 KiB.
+    hsize_t meta_block = 0;
+
+    /// Restricts the file format to the latest version, enabling its more
+    /// efficient indexes for appended datasets.
+    bool latest_format = false;
+
+    /// File space page size for paged aggregation. Zero disables paging.
+    hsize_t page_size = 0;
+
+    /// Page buffer size in bytes, a multiple of `page_size`. Zero disables
+    /// the page buffer.
+    size_t page_buffer = 0;
+
+    /// I/O driver.
+    hdaq::driver driver = hdaq::driver::sec2;
+
+    /// Memory allocation increment of the core driver, in bytes.
+    size_t core_increment = 64 * 1024 * 1024;
+
+    /// Writes core driver files to disk when they are closed.
+    bool core_backing_store = true;
+  };
+
+  /**
+   * @struct histogram
+   * @brief Histogram of durations in power-of-two buckets.
+   *
+   * Bucket `i` counts durations of `[2^i, 2^(i+1))` nanoseconds, so adding a
+   * sample costs a few instructions and no allocation.
+   */
+  struct histogram {
+    std::array<uint64_t,40> buckets; ///< Sample counts per bucket.
+    uint64_t count;                  ///< Number of samples.
+    uint64_t total;                  ///< Sum of all samples, in nanoseconds.
+    uint64_t max;                    ///< Largest sample, in nanoseconds.
+
+    histogram();
+
+    /**
+     * @brief Adds a sample.
+     * @param ns Duration in nanoseconds.
+     */
+    void add(const uint64_t ns);
+
+    /**
+     * @brief Estimates a quantile from the buckets.
+     * @param q Quantile, between 0 and 1.
+     * @return Upper edge of the bucket holding the quantile, in nanoseconds.
+     */
+    uint64_t quantile(const double q) const;
+  };
+
+  /**
+   * @struct dataset_stats
+   * @brief I/O counters and per-phase timings of a dataset.
+   *
+   * `stage` times the copy of a record into the staging buffer, `extend` the
+   * dataset extension, `select` the dataspace setup and `write` the HDF5
+   * write. A chunk write is partial when it does not cover a whole chunk; the
+   * chunk then has to stay in, or be read back into, the chunk cache.
+   */
+  struct dataset_stats {
+    uint64_t records;        ///< Records inserted.
+    uint64_t bytes;          ///< Bytes of record data inserted.
+    uint64_t extends;        ///< Dataset extensions.
+    uint64_t flushes;        ///< Writes of the staging buffer.
+    uint64_t chunks;         ///< Chunks touched by writes.
+    uint64_t partial_chunks; ///< Chunks only partially covered by a write.
+    histogram stage;         ///< Staging copy durations.
+    histogram extend;        ///< Extension durations.
+    histogram select;        ///< Dataspace selection durations.
+    histogram write;         ///< Write durations.
+
+    dataset_stats();
+
+    /**
+     * @brief Accounts the chunks touched by a write.
+     * @param first Index of the first written record.
+     * @param count Number of written records.
+     * @param chunk Records per chunk.
+     */
+    void written(const uint64_t first, const uint64_t count, const uint64_t chunk);
+  };
+
+  /**
+   * @struct stats_report
+   * @brief Snapshot of the instrumentation of an interface.
+   */
+  struct stats_report {
+    double mdc_hit_rate;  ///< Metadata cache hit rate since the last report.
+    size_t mdc_size;      ///< Current metadata cache size in bytes.
+    int mdc_entries;      ///< Current number of metadata cache entries.
+    uint64_t errors;      ///< HDF5 errors caught by `insert`.
+    std::map<std::string, dataset_stats> datasets; ///< Per-dataset stats.
+  };
+
+  /**
+   * @class stopwatch
+   * @brief Measures consecutive phases with a monotonic clock.
+   */
+  class stopwatch {
+    public:
+      stopwatch();
+
+      /**
+       * @brief Time since construction or the previous lap.
+       * @return Elapsed time in nanoseconds.
+       */
+      uint64_t lap();
+
+    private:
+      std::chrono::steady_clock::time_point last; ///< Start of the lap.
+  };
+}
+#include <impl_stats.ipp>
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace hdaq {
+  template <typename T> class handle;
+
   /**
    * @class interface
    * @brief Manages HDF5 file creation and manipulation.
@@ -237,31 +838,79 @@ namespace hdaq {
        */
       interface();
 
+      /**
+       * @brief Flushes all staged records before the file is closed.
+       */
+      ~interface();
+
+      interface(const interface&) = delete;
+      interface& operator=(const interface&) = delete;
+
       /**
        * @brief Sets hdf5 filename, closing previous file
+       *
+       * An existing file is reopened to resume appending: its datasets are
+       * rediscovered with their current extents, and datasets written with
+       * checkpoints are truncated to their last checkpoint, dropping records
+       * that may have been partially written before a crash, and checkpointed
+       * again at once. A missing file is created. Handles of the previous file become invalid.
+       * @param fname Name of the file without extension.
+       * @param opts Access properties of the file; creation properties only
+       * apply to files created by this call or by a rollover.
+       * @note Files created with `file_options::latest_format` are marked
+       * open while written; after a crash, clear that mark with `h5clear -s`
+       * before resuming.
+       * @throws std::runtime_error If a dataset with reduction levels set by
+       * `set_reduction` does not hold arithmetic records; the file is closed
+       * again.
        */
-      void set_filename(const std::string& fname);
+      void set_filename(
+        const std::string& fname,
+        const file_options& opts = file_options()
+      );
 
       /**
        * @brief Constructor to create a new HDF5 file.
        * @param fname Name of the file without extension. Appends an index if
        * the file already exists.
+       * @param opts Creation and access properties of the file.
        */
-      interface(const std::string& fname);
+      interface(
+        const std::string& fname,
+        const file_options& opts = file_options()
+      );
 
       /**
-       * @brief Creates a new dataset within the HDF5 file.
+       * @brief Creates a new, empty dataset within the HDF5 file.
        * @note The size parameter defines the immutable size of the dataset.
        * Once set, all subsequent insertions must match this size exactly. This
        * design choice is made to avoid complications with irregular matrices,
        * ensuring datasets maintain consistent dimensions.
+       * @param name Dataset name. Groups in the path, such as `a/b` in
+       * `a/b/name`, are created as needed.
+       * @param size Number of elements per record.
+       * @param opts Layout, chunking and filter options.
+       * @return Handle to the created dataset.
+       * @tparam T Data type of the dataset.
+       */
+      template <typename T>
+      handle<T> create_dataset(
+        const std::string& name,
+        const size_t size,
+        const dataset_options& opts = dataset_options()
+      );
+
+      /**
+       * @brief Returns a handle to an existing dataset, such as one
+       * rediscovered by `set_filename`.
        * @param name Dataset name.
-       * @param size Initial dataset size.
-       * @return The created dataset object.
+       * @return Handle to the dataset.
+       * @throws std::runtime_error If the dataset does not exist or its
+       * memory type is not that of `T`.
        * @tparam T Data type of the dataset.
        */
       template <typename T>
-      H5::DataSet create_dataset(const std::string& name, const size_t size);
+      handle<T> open_dataset(const std::string& name);
 
       /**
        * @brief Writes or appends data to a dataset.
@@ -273,10 +922,52 @@ namespace hdaq {
        * @param dataset Vector to write or append.
        * @param fname Name of the dataset to which the vector will be written
        * or appended to. 
+       * @param opts Creation options, used if the dataset does not exist yet.
        * @tparam T Data type of the vector.
        */
       template <typename T>
-      void insert(const class dataset<T>& data, const std::string& fname);
+      void insert(
+        const class dataset<T>& data,
+        const std::string& fname,
+        const dataset_options& opts = dataset_options()
+      );
+
+      /**
+       * @brief Writes or appends a record held in caller-owned memory.
+       * @note Unbuffered datasets are written directly from the viewed
+       * memory, strided views included, without an intermediate copy.
+       * @param data View of the record to write or append.
+       * @param fname Name of the dataset to which the record will be written
+       * or appended to.
+       * @param opts Creation options, used if the dataset does not exist yet.
+       * @tparam T Data type of the record.
+       */
+      template <typename T>
+      void insert(
+        const class view<T>& data,
+        const std::string& fname,
+        const dataset_options& opts = dataset_options()
+      );
+
+      /**
+       * @brief Appends data to a dataset identified by a handle, skipping the
+       * name lookup.
+       * @param data Vector to append.
+       * @param dset Handle returned by `create_dataset`.
+       * @tparam T Data type of the vector.
+       */
+      template <typename T>
+      void insert(const class dataset<T>& data, const handle<T>& dset);
+
+      /**
+       * @brief Appends a record held in caller-owned memory to a dataset
+       * identified by a handle, skipping the name lookup.
+       * @param data View of the record to append.
+       * @param dset Handle returned by `create_dataset`.
+       * @tparam T Data type of the record.
+       */
+      template <typename T>
+      void insert(const class view<T>& data, const handle<T>& dset);
 
       /**
        * @brief Writes attributes to an existing dataset.
@@ -295,58 +986,1339 @@ namespace hdaq {
       template <typename T>
       void insert(const class attribute<T>& attr, const std::string& fname);
 
-    private:
-      H5::H5File file;                             ///< HDF5 file object.
-      std::map<std::string, H5::DataSet> map_dset; ///< Map of dataset objects
+      /**
+       * @brief Enables buffered appends for a dataset.
+       *
+       * Appended records are collected in an in-memory staging block and
+       * written with a single extend and a single hyperslab write once the
+       * block is full, on `flush`, on `set_filename` or on destruction. The
+       * block holds at most `records` records and at most `bytes` bytes,
+       * whichever limit is reached first; a limit of zero is ignored. Setting
+       * both limits to zero disables buffering again.
+       * @note The policy may be set before the dataset exists; it is applied
+       * on creation.
+       * @param fname Name of the dataset.
+       * @param records Maximum number of staged records.
+       * @param bytes Maximum size of the staging block in bytes.
+       */
+      void set_buffer(
+        const std::string& fname, const size_t records, const size_t bytes = 0
+      );
 
       /**
-       * @brief Determines the HDF5 data type corresponding to a C++ data type.
-       * @return Corresponding HDF5 data type.
-       * @tparam T C++ data type.
+       * @brief Sets the buffering policy for datasets without an explicit one.
+       * @param records Maximum number of staged records.
+       * @param bytes Maximum size of the staging block in bytes.
        */
-      template <typename T>
-      const H5::PredType get_h5type();
-      
+      void set_buffer(const size_t records, const size_t bytes = 0);
+
+      /**
+       * @brief Writes all staged records and flushes the file to disk.
+       */
+      void flush();
+
+      /**
+       * @brief Writes the staged records of a single dataset.
+       * @param fname Name of the dataset.
+       */
+      void flush(const std::string& fname);
+
+      /**
+       * @brief Computes decimated and min/max/mean/RMS companion datasets of
+       * a dataset while it is written, see `reduction_options`.
+       *
+       * The companion datasets are created together with the dataset, with
+       * the same options except for the chunk, which is divided by the
+       * decimation or block factor, and linked to it by attributes: the dataset lists
+       * its levels in `hdaq_levels` and `hdaq_decimate`, and each companion
+       * names its source, statistic and block size in `hdaq_source`,
+       * `hdaq_reduction` and `hdaq_factor`. Summaries are stored as doubles.
+       * @param fname Name of the dataset.
+       * @param opts Decimation and levels.
+       * @note Must be called before the dataset is created. Levels require
+       * records of arithmetic type.
+       */
+      void set_reduction(const std::string& fname, const reduction_options& opts);
+
+      /**
+       * @brief Enables automatic file rollover.
+       *
+       * New files are named after the name given to the constructor or
+       * `set_filename`, followed by a sequence number or a timestamp. A
+       * timestamp is the time of the switch to the file, not of its
+       * preparation. Dataset handles remain valid across a rollover.
+       * @param opts Rollover limits and naming. Default options disable the
+       * rollover.
+       * @throws std::runtime_error If a limit is set and the file name is
+       * empty.
+       */
+      void set_rollover(const rollover_options& opts);
+
+      /**
+       * @brief Enables periodic durable checkpoints.
+       * @param opts Checkpoint cadence. Default options disable checkpoints.
+       */
+      void set_checkpoint(const checkpoint_options& opts);
+
+      /**
+       * @brief Writes a checkpoint immediately, see `checkpoint_options`.
+       *
+       * Once a file holds a checkpoint, it is refreshed whenever the file is
+       * closed cleanly, so a later `set_filename` keeps every record.
+       */
+      void checkpoint();
+
+      /**
+       * @brief Switches the file to single-writer/multiple-reader mode.
+       *
+       * Readers opened with `reader(fname, true)` can then follow the
+       * datasets while they grow, see `tail`. HDF5 does not allow creating
+       * datasets, groups or attributes in this mode, so all datasets must be
+       * created beforehand with `create_dataset`. The mode carries over to
+       * the files of a rollover and ends with `set_filename`. Checkpoints
+       * are removed, since they cannot be updated in this mode.
+       * @param opts Flush cadence of the datasets.
+       * @note The file must be created with `file_options::latest_format`,
+       * otherwise `std::runtime_error` is thrown.
+       */
+      void start_swmr(const swmr_options& opts = swmr_options());
+
+      /**
+       * @brief Snapshot of the I/O counters, phase timings and cache
+       * statistics.
+       *
+       * Counters and timings are only collected when compiled with
+       * `HDAQ_ENABLE_STATS` and read zero otherwise; the metadata cache
+       * figures come from HDF5 and are always available. The raw-data chunk
+       * cache exposes no statistics through the HDF5 API, see
+       * `dataset_stats::partial_chunks` instead.
+       */
+      const stats_report stats();
+
+      /**
+       * @brief Exports the statistics periodically.
+       *
+       * With `HDAQ_ENABLE_STATS`, `insert` passes a fresh `stats()` report to
+       * the sink once `period` has elapsed since the previous one, and the
+       * destructor passes a final report. The metadata cache hit rate is
+       * reset after each report.
+       * @param sink Callback receiving the reports, empty to disable.
+       * @param period Minimum time between two reports.
+       */
+      void set_stats_sink(
+        const std::function<void(const stats_report&)>& sink,
+        const std::chrono::milliseconds period
+      );
+
       /**
-       * @brief Generates a unique HDF5 file name.
+       * @brief Name of the file currently written.
+       */
+      const std::string filename() const;
+
+    private:
+      template <typename> friend class handle;
+      friend class async_interface;
+      friend void merge_shards(
+        const std::string& master,
+        const std::vector<std::string>& shards
+      );
+
+      /**
+       * @brief Staging limits of a buffered dataset.
+       */
+      struct buffer_policy {
+        size_t records; ///< Maximum number of staged records.
+        size_t bytes;   ///< Maximum staging block size in bytes.
+      };
+
+      struct reduction;
+
+      /**
+       * @brief Bookkeeping kept for every dataset written by the interface.
+       *
+       * The extent is tracked here so that appends never have to query the
+       * dataspace of the dataset.
+       */
+      struct dset_info {
+        H5::DataSet dset;                 ///< HDF5 dataset object.
+        H5::DataType type;                ///< Memory type of the elements.
+        const std::type_info* ctype;      ///< C++ type of the staged elements.
+        hdaq::layout layout;              ///< Orientation of the records.
+        hsize_t size;                     ///< Number of elements per record.
+        hsize_t nrec;                     ///< Number of records in the file.
+        size_t rsize;                     ///< Size of a record in bytes.
+        size_t capacity;                  ///< Staging capacity in records.
+        size_t nstaged;                   ///< Number of staged records.
+        std::vector<unsigned char> stage; ///< Staging block in file order.
+        hsize_t chunk;                    ///< Records per chunk.
+        dataset_stats stats;              ///< Instrumentation counters.
+        size_t swmr_count;                ///< Records since the SWMR flush.
+        std::chrono::steady_clock::time_point
+          swmr_last;                      ///< Time of the SWMR flush.
+        reduction* reduce;                ///< Reduction stage, if any.
+      };
+
+      /**
+       * @brief Running block statistics of one reduction level.
+       */
+      struct reduction_level {
+        size_t factor;                    ///< Records per block.
+        size_t count;                     ///< Records in the current block.
+        std::vector<double> min;          ///< Element-wise minimum.
+        std::vector<double> max;          ///< Element-wise maximum.
+        std::vector<double> sum;          ///< Element-wise sum.
+        std::vector<double> sumsq;        ///< Element-wise sum of squares.
+        std::array<dset_info*,4> dsets;   ///< Min, max, mean, RMS datasets.
+      };
+
+      /**
+       * @brief Reduction stage of a dataset.
+       */
+      struct reduction {
+        reduction_options opts;              ///< Decimation and levels.
+        size_t nrec;                         ///< Records of the dataset.
+        dset_info* decimated;                ///< Decimated dataset, if any.
+        std::vector<reduction_level> levels; ///< Levels, finest first.
+        std::vector<double> mean;            ///< Scratch record for means.
+        std::vector<double> rms;             ///< Scratch record for RMS.
+      };
+
+      H5::H5File file;                         ///< HDF5 file object.
+      std::unordered_map<std::string, dset_info>
+        map_dset;                              ///< Datasets by full path
+      std::unordered_map<std::string, H5::Group>
+        map_group;                             ///< Groups by full path
+      std::unordered_map<std::string, buffer_policy>
+        map_buffer;                            ///< Buffer policies
+      std::unordered_map<std::string, reduction>
+        map_reduce;                            ///< Reduction stages
+      buffer_policy default_buffer;            ///< Policy for other datasets
+      file_options fopts;                      ///< Properties of the files
+
+      /**
+       * @brief Layout of a dataset to replicate in the next file.
+       */
+      struct dset_spec {
+        std::string path;              ///< Full path of the dataset.
+        H5::DataType type;             ///< Data type of the elements.
+        H5::DSetCreatPropList plist;   ///< Creation properties.
+        std::array<hsize_t,2> maxdims; ///< Maximum dimensions.
+      };
+
+      /**
+       * @brief File prepared for the next rollover.
+       */
+      struct next_file {
+        next_file(const std::string& n, const file_options& opts) :
+          name(n), file(file_create(n, opts)) {}
+
+        std::string name;              ///< File name.
+        H5::H5File file;               ///< HDF5 file object.
+        std::unordered_map<std::string, H5::DataSet>
+          dsets;                       ///< Replicated datasets by path.
+      };
+
+      std::string fbase;                       ///< Base name of the files
+      uint64_t nerrors;                        ///< Errors caught by insert
+      std::function<void(const stats_report&)>
+        stats_sink;                            ///< Statistics export
+      std::chrono::milliseconds stats_period;  ///< Time between reports
+      std::chrono::steady_clock::time_point
+        stats_last;                            ///< Time of the last report
+      rollover_options roll;                   ///< Rollover policy
+      bool roll_enabled;                       ///< Any rollover limit is set
+      size_t roll_seq;                         ///< Last sequence number
+      size_t roll_bytes;                       ///< Bytes in the current file
+      size_t roll_records;                     ///< Records in the current file
+      std::chrono::steady_clock::time_point
+        roll_start;                            ///< Opening of the file
+      std::future<std::unique_ptr<next_file>>
+        roll_next;                             ///< Prepared next file
+      swmr_options swmr;                       ///< SWMR flush cadence
+      bool swmr_enabled;                       ///< File is in SWMR mode
+      checkpoint_options ckpt;                 ///< Checkpoint cadence
+      bool ckpt_enabled;                       ///< Any checkpoint limit is set
+      size_t ckpt_records;                     ///< Records since checkpoint
+      std::chrono::steady_clock::time_point
+        ckpt_last;                             ///< Time of the checkpoint
+      bool ckpt_written;                       ///< File holds a checkpoint
+      size_t generation;                       ///< Bumped when handles expire
+
+      /**
+       * @brief Generates a unique HDF5 file name, appending an index if
+       * `name.h5` exists.
        * @param name Base file name.
-       * @param i Index to append for uniqueness.
        * @return Generated HDF5 file name.
        */
-      const std::string 
-      get_h5fname(const std::string& name, const unsigned int i = 0);
+      static const std::string get_h5fname(const std::string& name);
+
+      /**
+       * @brief Finds an unused file index after a run of used ones.
+       *
+       * Indices from `first` on are assumed to be used contiguously, so the
+       * file system is probed O(log n) times for n used indices.
+       * @param name Name of the file with a given index.
+       * @param first Smallest candidate index.
+       * @return Index whose file does not exist.
+       */
+      static size_t file_free(
+        const std::function<std::string(size_t)>& name,
+        const size_t first
+      );
 
       /**
        * @brief Splits a dataset name into path and name components.
        * @param name Full dataset name.
-       * @return Pair containing the path and dataset name.
+       * @return Pair containing the absolute group path, ending with '/', and
+       * the dataset name.
        */
       const std::pair<std::string,std::string>
       get_h5pathname(const std::string& name);
 
+      /**
+       * @brief Opens a group, creating it and its parents if needed. Group
+       * handles are cached.
+       * @param path Absolute group path, ending with '/'.
+       * @return The group.
+       */
+      H5::Group& get_h5group(const std::string& path);
+
 
       /**
-       * @brief Writes a vector of data to a dataset.
-       * @param vec Data vector.
+       * @brief Orders a (records, elements) pair according to the layout of
+       * a dataset.
+       * @param info Dataset whose layout is used.
+       * @param records Extent along the record axis.
+       * @param elements Extent along the element axis.
+       * @return The pair in file dimension order.
+       */
+      static std::array<hsize_t,2>
+      dset_shape(const dset_info& info, hsize_t records, hsize_t elements);
+
+      /**
+       * @brief Creates a dataset and writes a record to it.
+       * @param vec View of the record.
        * @param name Dataset name.
-       * @tparam T Data type of the vector.
+       * @param opts Creation options.
+       * @return The created dataset.
+       * @tparam T Data type of the record.
        */
       template <typename T>
-      void dset_write(const class dataset<T>& vec, const std::string& name);
+      dset_info& dset_write(
+        const class view<T>& vec,
+        const std::string& name,
+        const dataset_options& opts
+      );
 
       /**
-       * @brief Appends a vector of data to an existing dataset.
-       * @param vec Data vector.
-       * @param name Dataset name.
-       * @tparam T Data type of the vector.
+       * @brief Writes or appends a record and runs the reduction, SWMR,
+       * rollover and checkpoint stages; the body of `insert`.
+       * @note HDF5 errors are not caught, so that `async_interface` can
+       * report them.
+       * @param vec View of the record.
+       * @param fname Dataset name.
+       * @param opts Creation options, used if the dataset does not exist yet.
+       * @tparam T Data type of the record.
+       */
+      template <typename T>
+      void dset_insert(
+        const class view<T>& vec,
+        const std::string& fname,
+        const dataset_options& opts
+      );
+
+      /**
+       * @brief Appends a record to an existing dataset.
+       *
+       * Records are staged only when `T` matches the memory type of the
+       * dataset; other records are written directly and converted by HDF5.
+       * @param vec View of the record.
+       * @param info Dataset to append to.
+       * @tparam T Data type of the record.
+       */
+      template <typename T>
+      void dset_append(const class view<T>& vec, dset_info& info);
+
+      /**
+       * @brief Writes the staged records of a dataset with one extend and one
+       * hyperslab write.
+       * @param info Dataset to flush.
+       */
+      void dset_flush(dset_info& info);
+
+      /**
+       * @brief Writes the staged records of all datasets and flushes the
+       * file; the body of `flush`, without catching HDF5 errors.
+       */
+      void file_flush();
+
+      /**
+       * @brief Applies a buffering policy to a dataset, flushing and resizing
+       * its staging block.
+       * @param info Dataset to configure.
+       * @param policy Buffering policy.
+       */
+      void dset_buffer(dset_info& info, const buffer_policy& policy);
+
+      /**
+       * @brief Creates the companion datasets of a reduction stage.
+       * @param key Full path of the dataset.
+       * @param red Reduction stage of the dataset.
+       * @param opts Creation options of the dataset.
+       * @tparam T Data type of the records.
+       */
+      template <typename T>
+      void reduce_create(
+        const std::string& key,
+        reduction& red,
+        const dataset_options& opts
+      );
+
+      /**
+       * @brief Connects a reduction stage to its dataset and companion
+       * datasets and resets its accumulators.
+       * @param key Full path of the dataset.
+       * @param red Reduction stage of the dataset.
+       */
+      void reduce_attach(const std::string& key, reduction& red);
+
+      /**
+       * @brief Feeds the records of a resumed dataset since the start of the
+       * coarsest open block back into the levels, so that overview record
+       * `k` keeps covering raw records `[kF, (k+1)F)`.
+       * @param raw Dataset of the reduction stage.
+       * @param red Reduction stage of the dataset.
+       */
+      void reduce_replay(const dset_info& raw, reduction& red);
+
+      /**
+       * @brief Feeds an appended record into a reduction stage.
+       * @param vec View of the record.
+       * @param red Reduction stage of the dataset.
+       * @tparam T Data type of the record.
        */
       template <typename T>
-      void dset_append(const class dataset<T>& vec, const std::string& name);
+      void reduce_update(const class view<T>& vec, reduction& red);
+
+      /**
+       * @brief Accumulates a record into the finest level.
+       * @param vec View of the record.
+       * @param red Reduction stage of the dataset.
+       * @tparam T Arithmetic data type of the record.
+       */
+      template <typename T>
+      void reduce_accumulate(
+        const class view<T>& vec,
+        reduction& red,
+        std::true_type
+      );
+
+      /**
+       * @brief Ignores records of non-arithmetic types, which have no levels.
+       */
+      template <typename T>
+      void reduce_accumulate(const class view<T>&, reduction&, std::false_type);
+
+      /**
+       * @brief Writes a level once its block is complete and merges it into
+       * the next coarser level.
+       * @param red Reduction stage of the dataset.
+       * @param i Index of the level.
+       */
+      void reduce_carry(reduction& red, const size_t i);
+
+      /**
+       * @brief Clears the accumulators of a level.
+       * @param level Level to clear.
+       */
+      static void reduce_reset(reduction_level& level);
+
+      /**
+       * @brief Writes a string attribute to a dataset.
+       * @param dset Dataset to annotate.
+       * @param name Name of the attribute.
+       * @param value Value of the attribute.
+       */
+      static void attr_string(
+        const H5::DataSet& dset,
+        const std::string& name,
+        const std::string& value
+      );
+
+      /**
+       * @brief Writes an attribute to a dataset; the body of `insert`,
+       * without catching HDF5 errors.
+       * @param attr Attribute to write.
+       * @param fname Name of the dataset.
+       * @tparam T Attribute type.
+       */
+      template <typename T>
+      void attr_insert(const class attribute<T>& attr, const std::string& fname);
+
+      /**
+       * @brief Passes a report to the statistics sink when one is due.
+       */
+      void stats_update();
+
+      /**
+       * @brief Accounts an appended record and makes the dataset visible to
+       * SWMR readers when a flush is due.
+       * @param info Dataset the record was appended to.
+       */
+      void swmr_update(dset_info& info);
+
+      /**
+       * @brief Accounts an appended record and writes a checkpoint when one
+       * is due.
+       */
+      void checkpoint_update();
+
+      /**
+       * @brief Recursively registers the datasets of a reopened file and
+       * truncates them to their last checkpoint, setting `ckpt_written` if
+       * any was found.
+       * @param group Group to visit.
+       * @param path Full path of the group, ending with '/'.
+       */
+      void file_discover(const H5::Group& group, const std::string& path);
+
+      /**
+       * @brief Accounts an appended record and rolls over to the next file
+       * once a limit is reached.
+       * @param info Dataset the record was appended to.
+       */
+      void roll_update(const dset_info& info);
+
+      /**
+       * @brief Checks whether a fraction of any rollover limit is reached.
+       * @param fraction Fraction of the limits.
+       */
+      bool roll_reached(const double fraction) const;
+
+      /**
+       * @brief Starts preparing the next file with the current datasets.
+       */
+      void roll_prepare();
+
+      /**
+       * @brief Switches to the prepared file.
+       */
+      void roll_switch();
+
+      /**
+       * @brief Closes and deletes a prepared file that was not used.
+       */
+      void roll_discard();
+
+      /**
+       * @brief Generates the name of the next file. The first sequence number
+       * of a run is found with `file_free`, later ones are only probed once.
+       * @param keep Existing file that may be returned, the prepared file
+       * when a timestamp name is taken again at the switch.
+       */
+      const std::string roll_name(const std::string& keep = "");
+
+      /**
+       * @brief Creates a file and replicates datasets into it.
+       * @param name Name of the file.
+       * @param opts Creation and access properties of the file.
+       * @param specs Datasets to replicate.
+       * @return The prepared file.
+       */
+      static std::unique_ptr<next_file> roll_create(
+        const std::string& name,
+        const file_options& opts,
+        const std::vector<dset_spec>& specs
+      );
+
+      /**
+       * @brief Creates a file, overwriting an existing one.
+       * @param name Name of the file, including its extension.
+       * @param opts Creation and access properties of the file.
+       * @return The created file.
+       */
+      static H5::H5File
+      file_create(const std::string& name, const file_options& opts);
+
+      /**
+       * @brief Builds the file creation property list of a file.
+       * @param opts Properties of the file.
+       */
+      static H5::FileCreatPropList file_fcpl(const file_options& opts);
+
+      /**
+       * @brief Builds the file access property list of a file.
+       * @param opts Properties of the file.
+       */
+      static H5::FileAccPropList file_fapl(const file_options& opts);
+
+      /**
+       * @brief Describes the layout of an open dataset.
+       * @param path Full path of the dataset.
+       * @param info Dataset to describe.
+       * @return Layout of the dataset.
+       */
+      static dset_spec dset_describe(const std::string& path, const dset_info& info);
+
+      /**
+       * @brief Creates an empty dataset with the layout of another one,
+       * including intermediate groups.
+       * @param file File to create the dataset in.
+       * @param spec Layout of the dataset.
+       * @return The created dataset.
+       */
+      static H5::DataSet
+      dset_replicate(const H5::H5File& file, const dset_spec& spec);
+
+      /**
+       * @brief Copies all attributes of a dataset to another dataset.
+       * @param src Source dataset.
+       * @param dst Destination dataset.
+       */
+      static void attr_copy(const H5::DataSet& src, const H5::DataSet& dst);
+  };
+}
+
+namespace hdaq {
+  /**
+   * @class handle
+   * @brief Typed reference to a dataset of an `interface`.
+   *
+   * Returned by `interface::create_dataset` and `interface::open_dataset`.
+   * Inserting through a handle appends directly to the dataset without
+   * parsing or looking up its name, which is the fastest way to append in a
+   * hot loop.
+   * @note A handle stays valid across rollovers, until the file is changed
+   * with `interface::set_filename`. Inserting through an expired handle
+   * throws std::runtime_error. A handle must not outlive its interface.
+   * @tparam T Data type of the dataset.
+   */
+  template <typename T>
+  class handle {
+    public:
+      /**
+       * @brief Constructs an invalid handle.
+       */
+      handle();
+
+      /**
+       * @brief Checks whether the handle refers to a dataset that its
+       * interface still writes.
+       */
+      bool valid() const;
+
+      /**
+       * @brief Underlying HDF5 dataset object.
+       */
+      operator const H5::DataSet&() const;
+
+    private:
+      friend class interface;
+
+      /**
+       * @brief Constructs a handle to a dataset of an interface.
+       * @param owner Interface writing the dataset.
+       * @param info Dataset bookkeeping owned by the interface.
+       */
+      handle(const interface* owner, interface::dset_info* info);
+
+      const interface* owner;     ///< Interface writing the dataset.
+      size_t generation;          ///< Generation of the owner at creation.
+      interface::dset_info* info; ///< Referenced dataset.
   };
 }
+#include <handle.ipp>
 
 #include <impl_hdaq_public.ipp>
 #include <impl_hdaq_private.ipp>
 
+///////////////////////////////////////////////////////////////////////////////
+
+namespace hdaq {
+  /**
+   * @class ring
+   * @brief Bounded lock-free multi-producer queue.
+   *
+   * Every cell carries a sequence number that tells producers and consumers
+   * whether the cell is free or holds a value, so neither side needs a lock.
+   * Positions increase monotonically and are returned to the caller, which
+   * allows them to be used as tickets for ordering.
+   *
+   * @tparam T Trivially copyable element type.
+   */
+  template <typename T>
+  class ring {
+    public:
+      /**
+       * @brief Constructs a queue holding at least `capacity` elements. The
+       * capacity is rounded up to a power of two.
+       * @param capacity Minimum number of elements.
+       */
+      ring(const size_t capacity);
+
+      ring(const ring&) = delete;
+      ring& operator=(const ring&) = delete;
+
+      /**
+       * @brief Enqueues an element.
+       * @param value Element to enqueue.
+       * @param pos Position assigned to the element.
+       * @return False if the queue is full.
+       */
+      bool push(const T& value, size_t& pos);
+
+      /**
+       * @brief Dequeues the oldest element.
+       * @param value Dequeued element.
+       * @param pos Position of the dequeued element.
+       * @return False if the queue is empty.
+       */
+      bool pop(T& value, size_t& pos);
+
+      /**
+       * @brief Position the next element will be enqueued at.
+       */
+      size_t tail() const;
+
+      /**
+       * @brief Position the next element will be dequeued from.
+       */
+      size_t head() const;
+
+      /**
+       * @brief Approximate number of queued elements, at most `capacity()`.
+       */
+      size_t size() const;
+
+      /**
+       * @brief Number of elements the queue can hold.
+       */
+      size_t capacity() const;
+
+    private:
+      struct cell {
+        std::atomic<size_t> seq; ///< Sequence number of the cell.
+        T value;                 ///< Stored element.
+      };
+
+      std::vector<cell> cells;         ///< Cell storage.
+      const size_t mask;               ///< Capacity minus one.
+      char pad0[64];                   ///< Keeps the positions apart.
+      std::atomic<size_t> enqueue_pos; ///< Next producer position.
+      char pad1[64];                   ///< Keeps the positions apart.
+      std::atomic<size_t> dequeue_pos; ///< Next consumer position.
+      char pad2[64];                   ///< Keeps the positions apart.
+  };
+}
+#include <ring.ipp>
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace hdaq {
+  /**
+   * @brief Behaviour of `async_interface::insert` when the queue is full.
+   */
+  enum class backpressure {
+    block,       ///< Wait until the writer frees a slot.
+    drop_oldest, ///< Discard the oldest queued record.
+    error        ///< Throw std::runtime_error.
+  };
+
+  /**
+   * @class async_interface
+   * @brief Writes HDF5 files from a dedicated background thread.
+   *
+   * Records are moved into a bounded lock-free queue and written by a single
+   * writer thread that owns the underlying `interface`, so the latency seen
+   * by producers is that of a queue push rather than of a disk write. Any
+   * number of threads may insert concurrently. Records of one producer are
+   * written in the order they were inserted.
+   * @note The writer thread is the only thread issuing HDF5 calls for this
+   * file. Unless HDF5 is built thread-safe, other HDF5 usage in the process
+   * must not overlap with an active writer.
+   */
+  class async_interface {
+    public:
+
+      /**
+       * @brief Creates a new HDF5 file and starts the writer thread.
+       * @param fname Name of the file without extension. Appends an index if
+       * the file already exists.
+       * @param capacity Number of records the queue can hold.
+       * @param policy Behaviour when the queue is full.
+       * @param opts Creation and access properties of the file.
+       */
+      async_interface(
+        const std::string& fname,
+        const size_t capacity = 1024,
+        const backpressure policy = backpressure::block,
+        const file_options& opts = file_options()
+      );
+
+      /**
+       * @brief Writes all queued records and stops the writer thread.
+       */
+      ~async_interface();
+
+      async_interface(const async_interface&) = delete;
+      async_interface& operator=(const async_interface&) = delete;
+
+      /**
+       * @brief Queues a dataset record, taking ownership of its storage.
+       * @param data Record to write or append.
+       * @param fname Name of the dataset.
+       * @tparam T Data type of the record.
+       */
+      template <typename T>
+      void insert(class dataset<T>&& data, const std::string& fname);
+
+      /**
+       * @brief Queues a copy of a dataset record.
+       * @param data Record to write or append.
+       * @param fname Name of the dataset.
+       * @tparam T Data type of the record.
+       */
+      template <typename T>
+      void insert(const class dataset<T>& data, const std::string& fname);
+
+      /**
+       * @brief Queues an attribute for an existing or queued dataset.
+       * @note Attributes are never discarded by `backpressure::drop_oldest`.
+       * @param attr Attribute to write.
+       * @param fname Name of the dataset.
+       * @tparam T Attribute type.
+       */
+      template <typename T>
+      void insert(const class attribute<T>& attr, const std::string& fname);
+
+      /**
+       * @brief Queues the creation of an empty dataset, see
+       * `interface::create_dataset`.
+       * @param name Dataset name.
+       * @param size Number of elements per record.
+       * @param opts Layout, chunking and filter options.
+       * @tparam T Data type of the dataset.
+       */
+      template <typename T>
+      void create_dataset(
+        const std::string& name,
+        const size_t size,
+        const dataset_options& opts = dataset_options()
+      );
+
+      /**
+       * @brief Queues a rollover policy change, see `interface::set_rollover`.
+       * @param opts Rollover limits and naming.
+       */
+      void set_rollover(const rollover_options& opts);
+
+      /**
+       * @brief Queues a statistics sink change, see
+       * `interface::set_stats_sink`. The sink is called on the writer thread.
+       * @param sink Callback receiving the reports, empty to disable.
+       * @param period Minimum time between two reports.
+       */
+      void set_stats_sink(
+        const std::function<void(const stats_report&)>& sink,
+        const std::chrono::milliseconds period
+      );
+
+      /**
+       * @brief Queues a reduction stage, see `interface::set_reduction`.
+       * @param fname Name of the dataset.
+       * @param opts Decimation and levels.
+       */
+      void set_reduction(const std::string& fname, const reduction_options& opts);
+
+      /**
+       * @brief Queues a buffering policy change, see `interface::set_buffer`.
+       * @param fname Name of the dataset.
+       * @param records Maximum number of staged records.
+       * @param bytes Maximum size of the staging block in bytes.
+       */
+      void set_buffer(
+        const std::string& fname, const size_t records, const size_t bytes = 0
+      );
+
+      /**
+       * @brief Waits until every record queued before the call is written
+       * and the file is flushed.
+       * @note Rethrows the first exception raised on the writer thread since
+       * the last call, including the `H5::Exception` of a failed write or
+       * flush. Unlike `interface::insert`, the writer does not catch HDF5
+       * errors, so records that could not be written are reported here.
+       */
+      void flush();
+
+      /**
+       * @brief Current number of queued records.
+       */
+      size_t depth() const;
+
+      /**
+       * @brief Largest queue depth observed so far.
+       */
+      size_t high_water_mark() const;
+
+      /**
+       * @brief Number of records discarded by `backpressure::drop_oldest`.
+       */
+      size_t dropped() const;
+
+    private:
+
+      /**
+       * @brief Unit of work executed on the writer thread.
+       */
+      struct job {
+        virtual ~job() {}
+        virtual void run(interface& io) = 0;
+        virtual bool droppable() const { return false; }
+      };
+
+      template <typename T> struct insert_job;
+      template <typename T> struct attribute_job;
+      struct call_job;
+
+      interface io;                    ///< Interface owned by the writer.
+      ring<job*> queue;                ///< Pending jobs.
+      const backpressure policy;       ///< Behaviour on a full queue.
+
+      std::deque<std::pair<job*, size_t>> deferred; ///< Undroppable jobs
+      std::mutex mtx_drop;             ///< Guards dropping and `deferred`.
+
+      std::mutex mtx;                  ///< Guards the fields below.
+      std::condition_variable cv_work; ///< Wakes the writer.
+      std::condition_variable cv_done; ///< Signals completed flushes.
+      std::condition_variable cv_space;///< Wakes blocked producers.
+      std::atomic<size_t> nblocked;    ///< Producers waiting for a slot.
+      std::atomic<bool> sleeping;      ///< Writer is waiting for work.
+      std::atomic<bool> stopping;      ///< Writer should exit when idle.
+      std::atomic<size_t> completed;   ///< Positions below are written.
+      std::atomic<size_t> flush_target;///< Requested flush position.
+      size_t flushed;                  ///< Last flushed position.
+      std::exception_ptr error;        ///< First error of the writer.
+
+      std::atomic<size_t> hwm;         ///< Queue depth high water mark.
+      std::atomic<size_t> ndropped;    ///< Number of dropped records.
+
+      std::thread writer;              ///< Writer thread.
+
+      /**
+       * @brief Enqueues a job according to the backpressure policy.
+       * @param j Job to enqueue, owned by the queue afterwards.
+       * @param force Block even if the policy would drop or throw.
+       */
+      void submit(job* j, const bool force = false);
+
+      /**
+       * @brief Dequeues the next job for the writer.
+       */
+      bool next(job*& j, size_t& pos);
+
+      /**
+       * @brief Wakes producers blocked on a full queue after a slot was
+       * freed.
+       */
+      void release();
+
+      /**
+       * @brief Writer thread main loop.
+       */
+      void run();
+
+      /**
+       * @brief Executes a pending flush request once all records before it
+       * have been written.
+       */
+      void try_flush();
+  };
+}
+#include <impl_async.ipp>
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace hdaq {
+  /**
+   * @class reader
+   * @brief Reads back HDF5 files written by `interface`.
+   *
+   * Opens an existing file read-only and discovers its datasets. Records are
+   * read as hyperslabs into caller-provided buffers, so arbitrary record and
+   * element ranges can be accessed without loading a whole dataset. Records
+   * are always returned record-major, one record after the other, regardless
+   * of the layout used in the file; the layout is recognised from the
+   * unlimited dimension of the dataset.
+   * @note Errors are reported by throwing `std::runtime_error` or the
+   * corresponding `H5::Exception`.
+   */
+  class reader {
+    public:
+
+      /**
+       * @brief Opens an existing HDF5 file read-only.
+       * @param fname Name of the file, including its extension.
+       * @param swmr Opens the file as a SWMR reader, to follow datasets
+       * written by an interface in SWMR mode.
+       */
+      reader(const std::string& fname, const bool swmr = false);
+
+      /**
+       * @brief Updates the number of records of a dataset still being
+       * written, see `interface::start_swmr`.
+       * @param name Name of the dataset.
+       * @return Number of records.
+       */
+      size_t refresh(const std::string& name);
+
+      /**
+       * @brief Lists the full paths of all datasets in the file.
+       * @return Dataset paths, such as `/dataset` or `/group/dataset`.
+       */
+      const std::vector<std::string> datasets() const;
+
+      /**
+       * @brief Lists the attribute names of a dataset.
+       * @param name Name of the dataset.
+       * @return Attribute names.
+       */
+      const std::vector<std::string> attributes(const std::string& name) const;
+
+      /**
+       * @brief Reads an attribute of a dataset.
+       * @param name Name of the dataset.
+       * @param attr Name of the attribute.
+       * @return The attribute and its values.
+       * @tparam T Attribute type.
+       */
+      template <typename T>
+      class attribute<T> 
+      read_attribute(const std::string& name, const std::string& attr) const;
+
+      /**
+       * @brief Number of records in a dataset.
+       * @param name Name of the dataset.
+       */
+      size_t records(const std::string& name) const;
+
+      /**
+       * @brief Number of elements per record of a dataset.
+       * @param name Name of the dataset.
+       */
+      size_t size(const std::string& name) const;
+
+      /**
+       * @brief Number of records per chunk of a dataset.
+       * @param name Name of the dataset.
+       */
+      size_t chunk_records(const std::string& name) const;
+
+      /**
+       * @brief Orientation of the records of a dataset within the file.
+       * @param name Name of the dataset.
+       */
+      hdaq::layout layout(const std::string& name) const;
+
+      /**
+       * @brief Underlying HDF5 dataset, for properties not exposed here.
+       * @param name Name of the dataset.
+       */
+      const H5::DataSet& dataset(const std::string& name) const;
+
+      /**
+       * @brief Reads a range of whole records.
+       * @param name Name of the dataset.
+       * @param first Index of the first record.
+       * @param count Number of records.
+       * @param buf Destination holding at least `count * size(name)`
+       * elements.
+       * @tparam T Data type of the destination.
+       */
+      template <typename T>
+      void read(
+        const std::string& name,
+        const size_t first,
+        const size_t count,
+        T* buf
+      ) const;
+
+      /**
+       * @brief Reads a range of elements (channels) from a range of records.
+       * @param name Name of the dataset.
+       * @param first Index of the first record.
+       * @param count Number of records.
+       * @param efirst Index of the first element within each record.
+       * @param ecount Number of elements per record.
+       * @param buf Destination holding at least `count * ecount` elements.
+       * @tparam T Data type of the destination.
+       */
+      template <typename T>
+      void read(
+        const std::string& name,
+        const size_t first,
+        const size_t count,
+        const size_t efirst,
+        const size_t ecount,
+        T* buf
+      ) const;
+
+    private:
+
+      /**
+       * @brief Properties of a dataset discovered in the file.
+       */
+      struct dset_entry {
+        H5::DataSet dset;    ///< HDF5 dataset object.
+        hdaq::layout layout; ///< Orientation of the records.
+        hsize_t size;        ///< Number of elements per record.
+        hsize_t nrec;        ///< Number of records.
+        hsize_t chunk;       ///< Number of records per chunk.
+      };
+
+      H5::H5File file;                            ///< HDF5 file object.
+      std::map<std::string, dset_entry> map_dset; ///< Discovered datasets.
+
+      /**
+       * @brief Recursively registers all datasets below a group.
+       * @param group Group to visit.
+       * @param path Full path of the group, ending with '/'.
+       */
+      void discover(const H5::Group& group, const std::string& path);
+
+      /**
+       * @brief Looks up a dataset by name.
+       * @param name Name of the dataset, with or without leading '/'.
+       * @return The dataset entry.
+       */
+      const dset_entry& entry(const std::string& name) const;
+
+      /**
+       * @brief Looks up a dataset by name.
+       * @param name Name of the dataset, with or without leading '/'.
+       * @return The dataset entry.
+       */
+      dset_entry& entry(const std::string& name);
+  };
+
+  /**
+   * @class tail
+   * @brief Follows a dataset while it is being written.
+   *
+   * Each `poll` refreshes the dataset and returns only the records appended
+   * since the previous poll, so a live monitor reads every record once.
+   *
+   * @code
+   * hdaq::reader file("h5file.h5", true);
+   * hdaq::tail t(file, "dataset");
+   * std::vector<double> delta;
+   * while (running) {
+   *   const size_t n = t.poll(delta);   // n new records, record-major
+   *   std::this_thread::sleep_for(std::chrono::milliseconds(100));
+   * }
+   * @endcode
+   */
+  class tail {
+    public:
+
+      /**
+       * @brief Starts following a dataset.
+       * @param src Reader of the file, opened as a SWMR reader.
+       * @param name Name of the dataset.
+       * @param first Index of the first record to return; records before it
+       * are skipped.
+       */
+      tail(reader& src, const std::string& name, const size_t first = 0);
+
+      /**
+       * @brief Reads the records appended since the previous poll.
+       * @param out Receives the new records, record-major.
+       * @param max Maximum number of records to return, zero for all.
+       * @return Number of records returned.
+       * @tparam T Data type of the destination.
+       */
+      template <typename T>
+      size_t poll(std::vector<T>& out, const size_t max = 0);
+
+      /**
+       * @brief Index of the next record to return.
+       */
+      size_t position() const;
+
+    private:
+      reader& src;            ///< Reader of the file.
+      const std::string name; ///< Name of the dataset.
+      size_t pos;             ///< Next record to return.
+  };
+
+  /**
+   * @class stream
+   * @brief Streams the records of a dataset in chunk-aligned batches.
+   *
+   * Batches are read into an internal buffer. When HDF5 is built
+   * thread-safe (`H5_HAVE_THREADSAFE`), the next batch is read on a
+   * background thread while the current one is processed. Otherwise nothing
+   * is read ahead: the library cannot be entered from a second thread, so
+   * each batch is read when `next` requests it.
+   *
+   * @code
+   * hdaq::reader file("h5file.h5");
+   * hdaq::stream<double> s(file, "dataset");
+   * for (const hdaq::stream<double>::batch& b : s) {
+   *   // b.count records of b.size elements at b.data
+   * }
+   * @endcode
+   *
+   * @tparam T Data type of the records.
+   */
+  template <typename T>
+  class stream {
+    public:
+
+      /**
+       * @brief A block of consecutive records, stored record-major.
+       */
+      struct batch {
+        size_t first;  ///< Index of the first record.
+        size_t count;  ///< Number of records.
+        size_t size;   ///< Number of elements per record.
+        const T* data; ///< Record data, valid until the next batch.
+      };
+
+      /**
+       * @brief Input iterator over the batches of a stream.
+       */
+      class iterator {
+        public:
+          iterator(stream<T>* s);
+          const batch& operator*() const;
+          const batch* operator->() const;
+          iterator& operator++();
+          bool operator==(const iterator& other) const;
+          bool operator!=(const iterator& other) const;
+        private:
+          stream<T>* src; ///< Iterated stream, null at the end.
+      };
+
+      /**
+       * @brief Prepares streaming of a dataset.
+       * @param src Reader of the file.
+       * @param name Name of the dataset.
+       * @param nbatch Records per batch, rounded up to whole chunks. Zero
+       * uses one chunk per batch.
+       */
+      stream(const reader& src, const std::string& name, const size_t nbatch = 0);
+
+      /**
+       * @brief Waits for a pending read-ahead.
+       */
+      ~stream();
+
+      stream(const stream&) = delete;
+      stream& operator=(const stream&) = delete;
+
+      /**
+       * @brief Advances to the next batch.
+       * @return False once all records have been returned.
+       */
+      bool next();
+
+      /**
+       * @brief Current batch.
+       */
+      const batch& current() const;
+
+      /**
+       * @brief Advances to the first batch and returns an iterator to it.
+       */
+      iterator begin();
+
+      /**
+       * @brief Iterator past the last batch.
+       */
+      iterator end();
+
+    private:
+      const reader& src;          ///< Reader of the file.
+      const std::string name;     ///< Name of the dataset.
+      const size_t size;          ///< Number of elements per record.
+      const size_t total;         ///< Number of records.
+      size_t nbatch;              ///< Records per batch.
+      size_t pos;                 ///< First record not yet requested.
+      std::vector<T> front;       ///< Buffer of the current batch.
+      std::vector<T> back;        ///< Buffer of the read-ahead batch.
+      batch cur;                  ///< Current batch.
+      batch ahead;                ///< Read-ahead batch.
+      std::future<void> pending;  ///< Background read-ahead.
+
+      /**
+       * @brief Starts reading the batch following `pos` into `back`.
+       */
+      void prefetch();
+  };
+}
+#include <impl_reader.ipp>
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace hdaq {
+  /**
+   * @brief Index of the calling process within a parallel job.
+   *
+   * Read from the environment set by the launcher (`OMPI_COMM_WORLD_RANK`,
+   * `PMI_RANK` or `SLURM_PROCID`).
+   * @return The rank, or 0 outside of a parallel job.
+   */
+  size_t shard_rank();
+
+  /**
+   * @brief Number of processes of a parallel job.
+   *
+   * Read from `OMPI_COMM_WORLD_SIZE`, `PMI_SIZE` or `SLURM_NTASKS`.
+   * @return The number of processes, or 1 outside of a parallel job.
+   */
+  size_t shard_count();
+
+  /**
+   * @brief Name of the shard file written by one process or thread.
+   * @param base Base name shared by all shards, without extension.
+   * @param index Index of the shard, such as `shard_rank()`.
+   * @return `base_shard0000`, `base_shard0001`, ... to be passed to
+   * `interface`.
+   */
+  const std::string shard_name(const std::string& base, const size_t index);
+
+  /**
+   * @brief Stitches shard files into a master file of virtual datasets.
+   *
+   * Every writer (thread or process) writes its own shard through its own
+   * `interface`, so shards never contend for one file. Once they are closed,
+   * the coordinator calls this function to create, for each dataset name
+   * found in any shard, one virtual dataset concatenating the records of
+   * all shards in the given order. Attributes are taken from the first
+   * shard holding the dataset. No record data is copied; the master file
+   * only references the shards, which must stay next to it.
+   *
+   * @code
+   * // in each process
+   * hdaq::interface io(hdaq::shard_name("run", hdaq::shard_rank()));
+   * ...
+   * // in the coordinator, once all processes are done
+   * hdaq::merge_shards("run.h5", {"run_shard0000.h5", "run_shard0001.h5"});
+   * @endcode
+   *
+   * @param master Name of the master file, including its extension. An
+   * existing file is overwritten once the new master is complete; datasets
+   * without records in any shard are created empty.
+   * @param shards Names of the shard files, including their extension.
+   * @note Throws `std::runtime_error` when a dataset has a different type,
+   * record size or layout in two shards.
+   */
+  void merge_shards(
+    const std::string& master,
+    const std::vector<std::string>& shards
+  );
+}
+#include <impl_shard.ipp>
+
 ///////////////////////////////////////////////////////////////////////////////
 #endif
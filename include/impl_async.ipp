@@ -0,0 +1,359 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Async Interface Jobs
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+struct hdaq::async_interface::insert_job : hdaq::async_interface::job {
+  class dataset<T> data;
+  const std::string name;
+
+  insert_job(class dataset<T>&& d, const std::string& n) :
+    data(std::move(d)), name(n) {}
+
+  void run(interface& io) {
+    io.dset_insert<T>(hdaq::view<T>(data), name, dataset_options());
+  }
+  bool droppable() const { return true; }
+};
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+struct hdaq::async_interface::attribute_job : hdaq::async_interface::job {
+  const class attribute<T> attr;
+  const std::string name;
+
+  attribute_job(const class attribute<T>& a, const std::string& n) :
+    attr(a), name(n) {}
+
+  void run(interface& io) { io.attr_insert<T>(attr, name); }
+};
+
+/* ------------------------------------------------------------------------- */
+
+struct hdaq::async_interface::call_job : hdaq::async_interface::job {
+  const std::function<void(interface&)> call;
+
+  call_job(const std::function<void(interface&)>& c) : call(c) {}
+
+  void run(interface& io) { call(io); }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Async Interface Public Methods Implementations
+///////////////////////////////////////////////////////////////////////////////
+
+inline hdaq::async_interface::async_interface(
+  const std::string& fname,
+  const size_t capacity,
+  const backpressure policy,
+  const file_options& opts
+) :
+  io(fname, opts),
+  queue(capacity),
+  policy(policy),
+  nblocked(0),
+  sleeping(false),
+  stopping(false),
+  completed(0),
+  flush_target(0),
+  flushed(0),
+  error(),
+  hwm(0),
+  ndropped(0),
+  writer(&async_interface::run, this)
+{}
+
+/* ------------------------------------------------------------------------- */
+
+inline hdaq::async_interface::~async_interface() {
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    stopping.store(true);
+  }
+  cv_work.notify_one();
+  writer.join();
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+void
+hdaq::async_interface::insert(
+  class dataset<T>&& data,
+  const std::string& fname
+) {
+  submit(new insert_job<T>(std::move(data), fname));
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+void
+hdaq::async_interface::insert(
+  const class dataset<T>& data,
+  const std::string& fname
+) {
+  submit(new insert_job<T>(hdaq::dataset<T>(data), fname));
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+void
+hdaq::async_interface::insert(
+  const class attribute<T>& attr,
+  const std::string& fname
+) {
+  submit(new attribute_job<T>(attr, fname), true);
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+void
+hdaq::async_interface::create_dataset(
+  const std::string& name,
+  const size_t size,
+  const dataset_options& opts
+) {
+  submit(new call_job([name, size, opts](interface& io) {
+    io.create_dataset<T>(name, size, opts);
+  }), true);
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::async_interface::set_buffer(
+  const std::string& fname,
+  const size_t records,
+  const size_t bytes
+) {
+  submit(new call_job([fname, records, bytes](interface& io) {
+    io.set_buffer(fname, records, bytes);
+  }), true);
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::async_interface::set_rollover(const rollover_options& opts) {
+  submit(new call_job([opts](interface& io) {
+    io.set_rollover(opts);
+  }), true);
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::async_interface::set_stats_sink(
+  const std::function<void(const stats_report&)>& sink,
+  const std::chrono::milliseconds period
+) {
+  submit(new call_job([sink, period](interface& io) {
+    io.set_stats_sink(sink, period);
+  }), true);
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::async_interface::set_reduction(
+  const std::string& fname,
+  const reduction_options& opts
+) {
+  submit(new call_job([fname, opts](interface& io) {
+    io.set_reduction(fname, opts);
+  }), true);
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::async_interface::flush() {
+  const size_t target = queue.tail();
+  size_t current = flush_target.load();
+  while (current < target &&
+         !flush_target.compare_exchange_weak(current, target)) {}
+
+  std::unique_lock<std::mutex> lock(mtx);
+  cv_work.notify_one();
+  cv_done.wait(lock, [this, target]() { return flushed >= target; });
+
+  if (error) {
+    const std::exception_ptr e = error;
+    error = nullptr;
+    lock.unlock();
+    std::rethrow_exception(e);
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline size_t
+hdaq::async_interface::depth() const {
+  return queue.size();
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline size_t
+hdaq::async_interface::high_water_mark() const {
+  return hwm.load(std::memory_order_relaxed);
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline size_t
+hdaq::async_interface::dropped() const {
+  return ndropped.load(std::memory_order_relaxed);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Async Interface Private Methods Implementations
+///////////////////////////////////////////////////////////////////////////////
+
+inline void
+hdaq::async_interface::submit(job* j, const bool force) {
+  size_t pos = 0;
+  while (!queue.push(j, pos)) {
+    if (force || policy == backpressure::block) {
+      // announce the wait before retrying, so that the writer either sees a
+      // blocked producer or the retry sees the freed slot
+      std::unique_lock<std::mutex> lock(mtx);
+      nblocked.fetch_add(1);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      const bool pushed = queue.push(j, pos);
+      if (!pushed) cv_space.wait_for(lock, std::chrono::milliseconds(10));
+      nblocked.fetch_sub(1);
+      if (pushed) break;
+    } else if (policy == backpressure::error) {
+      delete j;
+      throw std::runtime_error("queue is full");
+    } else {
+      std::lock_guard<std::mutex> lock(mtx_drop);
+      job* old = nullptr;
+      size_t opos = 0;
+      if (queue.pop(old, opos)) {
+        release();
+        if (old->droppable()) {
+          delete old;
+          ndropped.fetch_add(1, std::memory_order_relaxed);
+        } else {
+          deferred.push_back(std::make_pair(old, opos));
+        }
+      }
+    }
+  }
+
+  const size_t depth = queue.size();
+  size_t current = hwm.load(std::memory_order_relaxed);
+  while (depth > current &&
+         !hwm.compare_exchange_weak(current, depth,
+                                    std::memory_order_relaxed)) {}
+
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> lock(mtx);
+    cv_work.notify_one();
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline bool
+hdaq::async_interface::next(job*& j, size_t& pos) {
+  if (policy != backpressure::drop_oldest) {
+    if (queue.pop(j, pos)) return true;
+    pos = queue.head();
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mtx_drop);
+  if (!deferred.empty()) {
+    j = deferred.front().first;
+    pos = deferred.front().second;
+    deferred.pop_front();
+    return true;
+  }
+  if (queue.pop(j, pos)) return true;
+  pos = queue.head();
+  return false;
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::async_interface::release() {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (nblocked.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> lock(mtx);
+    cv_space.notify_all();
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::async_interface::run() {
+  // failures are rethrown by flush, so the stack is not printed as well
+  H5::Exception::dontPrint();
+  for (;;) {
+    job* j = nullptr;
+    size_t pos = 0;
+
+    if (next(j, pos)) {
+      release();
+      try {
+        j->run(io);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!error) error = std::current_exception();
+      }
+      delete j;
+      completed.store(pos + 1, std::memory_order_release);
+      try_flush();
+      continue;
+    }
+
+    completed.store(pos, std::memory_order_release);
+    try_flush();
+
+    std::unique_lock<std::mutex> lock(mtx);
+    if (stopping.load() && queue.tail() == pos) break;
+
+    sleeping.store(true);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (queue.tail() == pos && flush_target.load() <= flushed) {
+      cv_work.wait_for(lock, std::chrono::milliseconds(10));
+    }
+    sleeping.store(false);
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::async_interface::try_flush() {
+  const size_t target = flush_target.load(std::memory_order_acquire);
+  if (target <= flushed) return;
+  if (completed.load(std::memory_order_acquire) < target) return;
+
+  try {
+    io.file_flush();
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!error) error = std::current_exception();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    flushed = target;
+  }
+  cv_done.notify_all();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// End
+///////////////////////////////////////////////////////////////////////////////
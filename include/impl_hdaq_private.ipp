@@ -2,38 +2,52 @@
 /// Interface Private Methods Implementations
 ///////////////////////////////////////////////////////////////////////////////
 
-template <typename T>
-const H5::PredType 
-hdaq::interface::get_h5type() {
-  if (std::is_same<T, int>::value)         return H5::PredType::NATIVE_INT;
-  else if (std::is_same<T, size_t>::value) return H5::PredType::NATIVE_HSIZE;
-  else if (std::is_same<T, time_t>::value) return H5::PredType::NATIVE_LONG;
-  else if (std::is_same<T, float>::value)  return H5::PredType::NATIVE_FLOAT;
-  else if (std::is_same<T, double>::value) return H5::PredType::NATIVE_DOUBLE;
-  else if (std::is_same<T, bool>::value)   return H5::PredType::NATIVE_HBOOL;
-  return H5::PredType::NATIVE_DOUBLE;
+// TODO :
+//  Make this more flexible
+inline const std::string 
+hdaq::interface::get_h5fname(const std::string& name) {
+  const std::function<std::string(size_t)> fname = [&name](size_t i) {
+    return i? name + std::to_string(i) + ".h5" : name + ".h5";
+  };
+  return fname(file_free(fname, 0));
 }
 
 /* ------------------------------------------------------------------------- */
 
-// TODO :
-//  Make this more flexible
-const std::string 
-hdaq::interface::get_h5fname(const std::string& name, const unsigned int i) {
-  const std::string fname = i? name + std::to_string(i) + ".h5" : name + ".h5";
-  std::ifstream fp(fname);
-  if (!fp.is_open()) return fname;
-  return get_h5fname(name, i + 1);
+inline size_t
+hdaq::interface::file_free(
+  const std::function<std::string(size_t)>& name,
+  const size_t first
+) {
+  auto exists = [&name](size_t i) {
+    return std::ifstream(name(i)).is_open();
+  };
+  if (!exists(first)) return first;
+
+  // gallop to a free index, then bisect between the last used and it
+  size_t used = first;
+  size_t free = first + 1;
+  while (exists(free)) {
+    used = free;
+    free = first + 2 * (free - first);
+  }
+  while (free - used > 1) {
+    const size_t mid = used + (free - used) / 2;
+    if (exists(mid)) used = mid;
+    else free = mid;
+  }
+  return free;
 }
 
 /* ------------------------------------------------------------------------- */
 
 #include <algorithm>
-const std::pair<std::string, std::string>
+inline const std::pair<std::string, std::string>
 hdaq::interface::get_h5pathname(const std::string& name) {
   const size_t split = name.find_last_of('/');
   if (split != std::string::npos) {
-    const std::string fpath = name.substr(0,split + 1);
+    const std::string fpath = name[0] == '/'?
+      name.substr(0,split + 1) : "/" + name.substr(0,split + 1);
     const std::string fname = name.substr(split + 1);
     return std::make_pair(fpath, fname);
   }
@@ -42,37 +56,157 @@ hdaq::interface::get_h5pathname(const std::string& name) {
 
 /* ------------------------------------------------------------------------- */
 
+inline H5::Group&
+hdaq::interface::get_h5group(const std::string& path) {
+  const std::unordered_map<std::string, H5::Group>::iterator it =
+    map_group.find(path);
+  if (it != map_group.end()) return it->second;
+  if (path == "/") {
+    return map_group.emplace(path, file.openGroup(path)).first->second;
+  }
+
+  const size_t split = path.find_last_of('/', path.size() - 2);
+  H5::Group& parent = get_h5group(path.substr(0, split + 1));
+  const std::string name = path.substr(split + 1, path.size() - split - 2);
+
+  const H5::Group group = parent.nameExists(name)?
+    parent.openGroup(name) : parent.createGroup(name);
+  return map_group.emplace(path, group).first->second;
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline std::array<hsize_t,2>
+hdaq::interface::dset_shape(
+  const dset_info& info,
+  hsize_t records,
+  hsize_t elements
+) {
+  if (info.layout == hdaq::layout::record_major) {
+    return std::array<hsize_t,2>{{records, elements}};
+  }
+  return std::array<hsize_t,2>{{elements, records}};
+}
+
+/* ------------------------------------------------------------------------- */
+
 template <typename T>
-H5::DataSet
+hdaq::handle<T>
 hdaq::interface::create_dataset(
   const std::string& name,
-  const size_t size
+  const size_t size,
+  const dataset_options& opts
 ) {
 
-  std::array<hsize_t,2> dims{{size, 1}};
-  std::array<hsize_t,2> maxdims{{size, H5S_UNLIMITED}};
-  std::array<hsize_t,2> chunkdims{{size, 1}};
+  if (swmr_enabled) {
+    throw std::runtime_error("datasets cannot be created in SWMR mode");
+  }
+
+  // checked before anything is created, so that a failed insert leaves no
+  // dataset behind that later inserts would append to without reduction
+  const std::pair<std::string, std::string> pathname = get_h5pathname(name);
+  const std::string key = pathname.first + pathname.second;
+  const std::unordered_map<std::string, reduction>::iterator red =
+    map_reduce.find(key);
+  if (red != map_reduce.end() && !red->second.opts.levels.empty() &&
+      !std::is_arithmetic<T>::value) {
+    throw std::runtime_error("reduction levels require arithmetic records");
+  }
+
+  dset_info info;
+  info.type = h5type<T>::get();
+  info.ctype = &typeid(T);
+  info.layout = opts.layout;
+  info.size = size;
+  info.nrec = 0;
+  info.rsize = size * sizeof(T);
+  info.capacity = 1;
+  info.nstaged = 0;
+
+  size_t nchunk = opts.chunk_records;
+  if (!nchunk) {
+    nchunk = std::max<size_t>(1, opts.chunk_bytes / std::max<size_t>(1, info.rsize));
+    if (opts.expected_records) nchunk = std::min(nchunk, opts.expected_records);
+  }
+  info.chunk = nchunk;
+  info.swmr_count = 0;
+  info.swmr_last = std::chrono::steady_clock::now();
+  info.reduce = nullptr;
+
+  std::array<hsize_t,2> dims = dset_shape(info, 0, size);
+  std::array<hsize_t,2> maxdims = dset_shape(info, H5S_UNLIMITED, size);
+  std::array<hsize_t,2> chunkdims = dset_shape(info, nchunk, size);
 
   H5::DataSpace dspace(dims.size(), dims.data(), maxdims.data());
   H5::DSetCreatPropList plist;
   plist.setChunk(chunkdims.size(), chunkdims.data());
-  H5::DataSet dset = file.createDataSet(name, get_h5type<T>(), dspace, plist);
-  map_dset[name] = dset;
+  if (opts.shuffle) plist.setShuffle();
+  if (opts.deflate) plist.setDeflate(std::min(opts.deflate, 9u));
+  if (opts.filter && H5Zfilter_avail(opts.filter) > 0) {
+    plist.setFilter(
+      opts.filter, H5Z_FLAG_OPTIONAL,
+      opts.filter_values.size(), opts.filter_values.data()
+    );
+  }
+  info.dset = get_h5group(pathname.first).createDataSet(
+    pathname.second, h5type<T>::get(), dspace, plist
+  );
+
+  dset_info& entry = map_dset[key];
+  entry = info;
 
-  return dset;
+  const std::unordered_map<std::string, buffer_policy>::const_iterator it =
+    map_buffer.find(key);
+  dset_buffer(entry, it != map_buffer.end() ? it->second : default_buffer);
+
+  if (red != map_reduce.end()) reduce_create<T>(key, red->second, opts);
+
+  return handle<T>(this, &entry);
 }
 
 /* ------------------------------------------------------------------------- */
 
 template <typename T>
-void
+hdaq::interface::dset_info&
 hdaq::interface::dset_write(
-  const hdaq::dataset<T>& vec, 
-  const std::string& name
+  const hdaq::view<T>& vec, 
+  const std::string& name,
+  const dataset_options& opts
+) {
+
+  const handle<T> dset = create_dataset<T>(name, vec.size(), opts);
+  dset_append<T>(vec, *dset.info);
+  return *dset.info;
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+void
+hdaq::interface::dset_insert(
+  const hdaq::view<T>& vec,
+  const std::string& fname,
+  const dataset_options& opts
 ) {
 
-  H5::DataSet dset = create_dataset<T>(name, vec.size());
-  dset.write(vec.data(), get_h5type<T>());
+  const std::pair<std::string, std::string> pathname = get_h5pathname(fname);
+  const std::string name = pathname.first + pathname.second;
+  const std::unordered_map<std::string, dset_info>::iterator it =
+    map_dset.find(name);
+  if(it == map_dset.end()) {
+    dset_info& info = dset_write<T>(vec, name, opts);
+    if (info.reduce) reduce_update<T>(vec, *info.reduce);
+    swmr_update(info);
+    roll_update(info);
+  } else {
+    dset_append<T>(vec, it->second);
+    if (it->second.reduce) reduce_update<T>(vec, *it->second.reduce);
+    swmr_update(it->second);
+    roll_update(it->second);
+  }
+  checkpoint_update();
+  HDAQ_STATS(stats_update();)
 
 }
 
@@ -82,32 +216,877 @@ hdaq::interface::dset_write(
 template <typename T>
 void
 hdaq::interface::dset_append(
-  const hdaq::dataset<T>& vec,
-  const std::string& name
+  const hdaq::view<T>& vec,
+  dset_info& info
 ) {
 
-  if(map_dset.find(name) == map_dset.end()) {
-    throw std::runtime_error("dataset not found");
+  if (vec.size() != info.size) {
+    throw std::runtime_error("vector is not of same size as dataset");
   }
 
-  H5::DataSet& dset = map_dset[name];
-  H5::DataSpace dspace = dset.getSpace();
+  // the staging block holds elements of the memory type; records of any
+  // other type are written directly, so that HDF5 converts them
+  if (info.capacity > 1 && info.ctype != &typeid(T)) {
+    if (h5type<T>::get() == info.type) info.ctype = &typeid(T);
+    else dset_flush(info);
+  }
 
-  std::array<hsize_t,2>dims{{}};
-  dspace.getSimpleExtentDims(dims.data(), nullptr);
-  const std::array<hsize_t,2> ndims{{dims[0], dims[1] + 1}};
-  const std::array<hsize_t,2> offs{{0, dims[1]}};
-  const std::array<hsize_t,2> count{{dims[0], 1}};
+  HDAQ_STATS(stopwatch sw; info.stats.records++; info.stats.bytes += info.rsize;)
+  if (info.capacity > 1 && info.ctype == &typeid(T)) {
+    T* stage = reinterpret_cast<T*>(info.stage.data());
+    if (info.layout == hdaq::layout::record_major) {
+      T* row = stage + info.nstaged * info.size;
+      if (vec.stride() == 1) {
+        std::copy(vec.data(), vec.data() + vec.size(), row);
+      } else {
+        for (size_t i = 0; i < vec.size(); i++) row[i] = vec[i];
+      }
+    } else {
+      for (size_t i = 0; i < vec.size(); i++) {
+        stage[i * info.capacity + info.nstaged] = vec[i];
+      }
+    }
+    HDAQ_STATS(info.stats.stage.add(sw.lap());)
+    if (++info.nstaged == info.capacity) dset_flush(info);
+    return;
+  }
 
-  if (vec.size() != dims[0]) {
-    throw std::runtime_error("vector is not of same size as dataset");
+  const std::array<hsize_t,2> ndims = dset_shape(info, info.nrec + 1, info.size);
+  const std::array<hsize_t,2> offs = dset_shape(info, info.nrec, 0);
+  const std::array<hsize_t,2> count = dset_shape(info, 1, info.size);
+
+  info.dset.extend(ndims.data());
+  HDAQ_STATS(info.stats.extend.add(sw.lap()); info.stats.extends++;)
+  H5::DataSpace nspace(ndims.size(), ndims.data());
+  nspace.selectHyperslab(H5S_SELECT_SET, count.data(), offs.data());
+
+  const hsize_t mdims = info.size? (info.size - 1) * vec.stride() + 1 : 0;
+  const hsize_t mstride = vec.stride();
+  const hsize_t moffs = 0;
+  H5::DataSpace memspace(1, &mdims);
+  if (vec.stride() != 1) {
+    memspace.selectHyperslab(
+      H5S_SELECT_SET, &info.size, &moffs, &mstride
+    );
   }
+  HDAQ_STATS(info.stats.select.add(sw.lap());)
+  info.dset.write(vec.data(), h5type<T>::get(), memspace, nspace);
+  HDAQ_STATS(info.stats.write.add(sw.lap()); info.stats.written(info.nrec, 1, info.chunk);)
+  info.nrec++;
+
+}
+
+/* ------------------------------------------------------------------------- */
 
-  dset.extend(ndims.data());
-  H5::DataSpace nspace = dset.getSpace();
+inline void
+hdaq::interface::dset_flush(dset_info& info) {
+
+  if (info.nstaged == 0) return;
+
+  const std::array<hsize_t,2> ndims =
+    dset_shape(info, info.nrec + info.nstaged, info.size);
+  const std::array<hsize_t,2> offs = dset_shape(info, info.nrec, 0);
+  const std::array<hsize_t,2> count = dset_shape(info, info.nstaged, info.size);
+  const std::array<hsize_t,2> mdims = dset_shape(info, info.capacity, info.size);
+  const std::array<hsize_t,2> moffs{{0, 0}};
+
+  HDAQ_STATS(stopwatch sw;)
+  info.dset.extend(ndims.data());
+  HDAQ_STATS(info.stats.extend.add(sw.lap()); info.stats.extends++;)
+  H5::DataSpace nspace(ndims.size(), ndims.data());
   nspace.selectHyperslab(H5S_SELECT_SET, count.data(), offs.data());
-  H5::DataSpace memspace(1, &dims[0]);
-  dset.write(vec.data(), get_h5type<T>(), memspace, nspace);
+  H5::DataSpace memspace(mdims.size(), mdims.data());
+  memspace.selectHyperslab(H5S_SELECT_SET, count.data(), moffs.data());
+  HDAQ_STATS(info.stats.select.add(sw.lap());)
+  info.dset.write(info.stage.data(), info.type, memspace, nspace);
+  HDAQ_STATS(
+    info.stats.write.add(sw.lap()); info.stats.flushes++;
+    info.stats.written(info.nrec, info.nstaged, info.chunk);
+  )
+  info.nrec += info.nstaged;
+  info.nstaged = 0;
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::file_flush() {
+  for (auto& kv : map_dset) dset_flush(kv.second);
+  file.flush(H5F_SCOPE_GLOBAL);
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::dset_buffer(dset_info& info, const buffer_policy& policy) {
+
+  dset_flush(info);
+
+  size_t capacity = policy.records? policy.records :
+    std::numeric_limits<size_t>::max();
+  if (policy.bytes) {
+    capacity = std::min(
+      capacity, std::max<size_t>(1, policy.bytes / std::max<size_t>(1, info.rsize))
+    );
+  }
+  if (!policy.records && !policy.bytes) capacity = 1;
+
+  info.capacity = capacity;
+  info.stage.clear();
+  info.stage.shrink_to_fit();
+  if (capacity > 1) info.stage.resize(capacity * info.rsize);
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::stats_update() {
+
+  if (!stats_sink) return;
+  const std::chrono::steady_clock::time_point now =
+    std::chrono::steady_clock::now();
+  if (now - stats_last < stats_period) return;
+
+  stats_last = now;
+  stats_sink(stats());
+  H5Freset_mdc_hit_rate_stats(file.getId());
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::swmr_update(dset_info& info) {
+
+  if (!swmr_enabled) return;
+
+  const std::chrono::steady_clock::time_point now =
+    std::chrono::steady_clock::now();
+  if (
+    (swmr.flush_records && ++info.swmr_count >= swmr.flush_records) ||
+    (swmr.interval.count() && now - info.swmr_last >= swmr.interval)
+  ) {
+    dset_flush(info);
+    if (H5Dflush(info.dset.getId()) < 0) {
+      throw std::runtime_error("dataset flush failed");
+    }
+    info.swmr_count = 0;
+    info.swmr_last = now;
+  }
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::checkpoint_update() {
+
+  if (!ckpt_enabled) return;
+
+  if (
+    (ckpt.records && ++ckpt_records >= ckpt.records) ||
+    (ckpt.interval.count() &&
+      std::chrono::steady_clock::now() - ckpt_last >= ckpt.interval)
+  ) {
+    checkpoint();
+  }
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::file_discover(const H5::Group& group, const std::string& path) {
+
+  const hsize_t n = group.getNumObjs();
+  for (hsize_t i = 0; i < n; i++) {
+    const std::string name = group.getObjnameByIdx(i);
+    const H5O_type_t type = group.childObjType(name);
+
+    if (type == H5O_TYPE_GROUP) {
+      file_discover(group.openGroup(name), path + name + "/");
+      continue;
+    }
+    if (type != H5O_TYPE_DATASET) continue;
+
+    const H5::DataSet dset = group.openDataSet(name);
+    const H5::DataSpace dspace = dset.getSpace();
+    if (dspace.getSimpleExtentNdims() != 2) continue;
+
+    std::array<hsize_t,2> dims{{}};
+    std::array<hsize_t,2> maxdims{{}};
+    dspace.getSimpleExtentDims(dims.data(), maxdims.data());
+    if ((maxdims[0] == H5S_UNLIMITED) == (maxdims[1] == H5S_UNLIMITED)) continue;
+    const bool rm = maxdims[0] == H5S_UNLIMITED;
+
+    dset_info info;
+    info.dset = dset;
+    // staging blocks hold elements in memory, so they are sized and written
+    // with the native type rather than the type stored in the file
+    const hid_t native =
+      H5Tget_native_type(dset.getDataType().getId(), H5T_DIR_DEFAULT);
+    if (native < 0) {
+      throw std::runtime_error("no native type for dataset " + path + name);
+    }
+    info.type = H5::DataType(native);
+    H5Tclose(native);
+    info.ctype = nullptr;
+    info.layout = rm? hdaq::layout::record_major : hdaq::layout::channel_major;
+    info.size = rm? dims[1] : dims[0];
+    info.nrec = rm? dims[0] : dims[1];
+    info.rsize = info.size * info.type.getSize();
+    info.capacity = 1;
+    info.nstaged = 0;
+    info.swmr_count = 0;
+    info.swmr_last = std::chrono::steady_clock::now();
+    info.reduce = nullptr;
+
+    std::array<hsize_t,2> chunkdims{{}};
+    dset.getCreatePlist().getChunk(chunkdims.size(), chunkdims.data());
+    info.chunk = rm? chunkdims[0] : chunkdims[1];
+
+    // records after the last checkpoint may be partially written; the
+    // caller writes a fresh checkpoint once all datasets are truncated
+    if (dset.attrExists("hdaq_checkpoint")) {
+      uint64_t nrec = 0;
+      dset.openAttribute("hdaq_checkpoint").read(h5type<uint64_t>::get(), &nrec);
+      ckpt_written = true;
+      if (nrec < info.nrec) {
+        info.nrec = nrec;
+        const std::array<hsize_t,2> ndims = dset_shape(info, nrec, info.size);
+        if (H5Dset_extent(dset.getId(), ndims.data()) < 0) {
+          throw std::runtime_error("failed to truncate dataset " + path + name);
+        }
+      }
+    }
+
+    const std::string key = path + name;
+    dset_info& entry = map_dset[key];
+    entry = info;
+
+    const std::unordered_map<std::string, buffer_policy>::const_iterator it =
+      map_buffer.find(key);
+    dset_buffer(entry, it != map_buffer.end() ? it->second : default_buffer);
+  }
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::roll_update(const dset_info& info) {
+
+  if (!roll_enabled) return;
+
+  roll_bytes += info.rsize;
+  roll_records++;
+  if (!roll_next.valid() && roll_reached(roll.prepare_at)) roll_prepare();
+  if (roll_reached(1.0)) roll_switch();
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline bool
+hdaq::interface::roll_reached(const double fraction) const {
+
+  if (roll.max_bytes && roll_bytes >= fraction * roll.max_bytes) {
+    return true;
+  }
+  if (roll.max_records && roll_records >= fraction * roll.max_records) {
+    return true;
+  }
+  if (roll.interval.count()) {
+    const std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - roll_start;
+    if (elapsed.count() >= fraction * roll.interval.count()) return true;
+  }
+  return false;
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::roll_prepare() {
+
+  std::vector<dset_spec> specs;
+  for (const auto& kv : map_dset) {
+    specs.push_back(dset_describe(kv.first, kv.second));
+  }
+
+#ifdef H5_HAVE_THREADSAFE
+  roll_next = std::async(
+    std::launch::async, &interface::roll_create, roll_name(), fopts, specs
+  );
+#else
+  // the library cannot be entered from another thread, so the file is
+  // created now rather than inside the insert that switches to it
+  std::promise<std::unique_ptr<next_file>> ready;
+  ready.set_value(roll_create(roll_name(), fopts, specs));
+  roll_next = ready.get_future();
+#endif
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::roll_switch() {
+
+  if (!roll_next.valid()) roll_prepare();
+  std::unique_ptr<next_file> next = roll_next.get();
+
+  // a checkpoint left in the closed file must cover all of its records
+  if (ckpt_written) checkpoint();
+
+  for (auto& kv : map_dset) {
+    dset_info& info = kv.second;
+    dset_flush(info);
+
+    if (next->dsets.find(kv.first) == next->dsets.end()) {
+      next->dsets.emplace(
+        kv.first, dset_replicate(next->file, dset_describe(kv.first, info))
+      );
+    }
+    attr_copy(info.dset, next->dsets.find(kv.first)->second);
+  }
+
+  map_group.clear();
+  file.close();
+  std::string name = next->name;
+  next.reset();
+
+  // the file was named when it was prepared; timestamps name the switch
+  if (roll.naming == hdaq::naming::timestamp) {
+    const std::string now = roll_name(name);
+    if (now != name && std::rename(name.c_str(), now.c_str()) == 0) name = now;
+  }
+  file.openFile(name, H5F_ACC_RDWR, file_fapl(fopts));
+
+  for (auto& kv : map_dset) {
+    kv.second.dset = file.openDataSet(kv.first);
+    kv.second.nrec = 0;
+  }
+  // overview blocks and decimation restart at the first record of the new
+  // file; partial blocks of the closed file are dropped
+  for (auto& kv : map_reduce) reduce_attach(kv.first, kv.second);
+
+  if (swmr_enabled && H5Fstart_swmr_write(file.getId()) < 0) {
+    throw std::runtime_error("failed to start SWMR write");
+  }
+  ckpt_written = false;
+  if (ckpt_enabled) checkpoint();
+
+  roll_bytes = 0;
+  roll_records = 0;
+  roll_start = std::chrono::steady_clock::now();
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::roll_discard() {
+
+  if (!roll_next.valid()) return;
+
+  std::unique_ptr<next_file> next = roll_next.get();
+  const std::string name = next->name;
+  next.reset();
+  std::remove(name.c_str());
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline const std::string
+hdaq::interface::roll_name(const std::string& keep) {
+
+  for (unsigned int i = 0;; i++) {
+    char stamp[32];
+    if (roll.naming == hdaq::naming::timestamp) {
+      const std::time_t now = std::time(nullptr);
+      std::strftime(stamp, sizeof(stamp), "%Y%m%dT%H%M%S", std::gmtime(&now));
+    } else {
+      if (roll_seq == 0) {
+        roll_seq = file_free([this](size_t i) {
+          char seq[32];
+          std::snprintf(seq, sizeof(seq), "%06zu", i);
+          return fbase + "_" + seq + ".h5";
+        }, 1) - 1;
+      }
+      std::snprintf(stamp, sizeof(stamp), "%06zu", ++roll_seq);
+    }
+
+    std::string name = fbase + "_" + stamp;
+    if (roll.naming == hdaq::naming::timestamp && i) {
+      name += "_" + std::to_string(i);
+    }
+    name += ".h5";
+
+    std::ifstream fp(name);
+    if (name == keep || !fp.is_open()) return name;
+  }
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline std::unique_ptr<hdaq::interface::next_file>
+hdaq::interface::roll_create(
+  const std::string& name,
+  const file_options& opts,
+  const std::vector<dset_spec>& specs
+) {
+
+  std::unique_ptr<next_file> next(new next_file(name, opts));
+  for (const dset_spec& spec : specs) {
+    next->dsets.emplace(spec.path, dset_replicate(next->file, spec));
+  }
+  return next;
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline hdaq::interface::dset_spec
+hdaq::interface::dset_describe(const std::string& path, const dset_info& info) {
+
+  const dset_spec spec{
+    path, info.type, info.dset.getCreatePlist(),
+    dset_shape(info, H5S_UNLIMITED, info.size)
+  };
+  return spec;
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline H5::DataSet
+hdaq::interface::dset_replicate(const H5::H5File& file, const dset_spec& spec) {
+
+  std::array<hsize_t,2> dims{{
+    spec.maxdims[0] == H5S_UNLIMITED ? 0 : spec.maxdims[0],
+    spec.maxdims[1] == H5S_UNLIMITED ? 0 : spec.maxdims[1]
+  }};
+  H5::DataSpace dspace(dims.size(), dims.data(), spec.maxdims.data());
+  H5::LinkCreatPropList lcpl;
+  lcpl.setCreateIntermediateGroup(true);
+  return file.createDataSet(
+    spec.path, spec.type, dspace, spec.plist, H5::DSetAccPropList::DEFAULT, lcpl
+  );
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::attr_copy(const H5::DataSet& src, const H5::DataSet& dst) {
+
+  const int n = src.getNumAttrs();
+  for (int i = 0; i < n; i++) {
+    const H5::Attribute attr = src.openAttribute(static_cast<unsigned int>(i));
+    const std::string name = attr.getName();
+    if (name == "hdaq_checkpoint" || dst.attrExists(name)) continue;
+
+    const H5::DataType type = attr.getDataType();
+    const H5::DataSpace dspace = attr.getSpace();
+    std::vector<unsigned char> buf(
+      type.getSize() * static_cast<size_t>(dspace.getSimpleExtentNpoints())
+    );
+    attr.read(type, buf.data());
+    dst.createAttribute(name, type, dspace).write(type, buf.data());
+  }
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline H5::H5File
+hdaq::interface::file_create(const std::string& name, const file_options& opts) {
+  return H5::H5File(name, H5F_ACC_TRUNC, file_fcpl(opts), file_fapl(opts));
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline H5::FileCreatPropList
+hdaq::interface::file_fcpl(const file_options& opts) {
+
+  H5::FileCreatPropList fcpl;
+  if (opts.page_size) {
+    fcpl.setFileSpaceStrategy(H5F_FSPACE_STRATEGY_PAGE, false, 1);
+    fcpl.setFileSpacePagesize(opts.page_size);
+  }
+  return fcpl;
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline H5::FileAccPropList
+hdaq::interface::file_fapl(const file_options& opts) {
+
+  H5::FileAccPropList fapl;
+
+  int mdc_nelmts = 0;
+  size_t slots = 0;
+  size_t bytes = 0;
+  double w0 = 0;
+  fapl.getCache(mdc_nelmts, slots, bytes, w0);
+  fapl.setCache(
+    mdc_nelmts,
+    opts.chunk_cache_slots? opts.chunk_cache_slots : slots,
+    opts.chunk_cache_bytes? opts.chunk_cache_bytes : bytes,
+    opts.chunk_cache_w0 < 0? w0 : std::min(opts.chunk_cache_w0, 1.0)
+  );
+
+  if (opts.alignment) fapl.setAlignment(opts.alignment_threshold, opts.alignment);
+  if (opts.meta_block) {
+    hsize_t meta_block = opts.meta_block;
+    fapl.setMetaBlockSize(meta_block);
+  }
+  if (opts.latest_format) {
+    fapl.setLibverBounds(H5F_LIBVER_LATEST, H5F_LIBVER_LATEST);
+  }
+  if (opts.page_size && opts.page_buffer) {
+    if (H5Pset_page_buffer_size(fapl.getId(), opts.page_buffer, 0, 0) < 0) {
+      throw std::runtime_error("invalid page buffer size");
+    }
+  }
+
+  if (opts.driver == hdaq::driver::core) {
+    fapl.setCore(opts.core_increment, opts.core_backing_store);
+  } else if (opts.driver == hdaq::driver::direct) {
+#ifdef H5_HAVE_DIRECT
+    const size_t block = opts.alignment? opts.alignment : 4096;
+    if (H5Pset_fapl_direct(fapl.getId(), block, block, 16 * block) < 0) {
+      throw std::runtime_error("direct driver setup failed");
+    }
+#else
+    throw std::runtime_error("direct driver not available in this HDF5 build");
+#endif
+  }
+
+  return fapl;
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+void
+hdaq::interface::reduce_create(
+  const std::string& key,
+  reduction& red,
+  const dataset_options& opts
+) {
+
+  const size_t size = map_dset.find(key)->second.size;
+  const H5::DataSet dset = map_dset.find(key)->second.dset;
+  const char* stats[] = {"min", "max", "mean", "rms"};
+
+  // companions grow F times slower, so a chunk spans as many raw records as
+  // a chunk of the dataset, and never more bytes than `chunk_bytes`
+  const size_t chunk = map_dset.find(key)->second.chunk;
+  auto scaled = [&opts, chunk](const size_t factor) {
+    dataset_options copts = opts;
+    copts.chunk_records = 0;
+    copts.expected_records = std::max<size_t>(1, chunk / factor);
+    return copts;
+  };
+
+  if (red.opts.decimate) {
+    const std::string name = key + "_every_" + std::to_string(red.opts.decimate);
+    const uint64_t factor = red.opts.decimate;
+    const H5::DataSet every =
+      create_dataset<T>(name, size, scaled(red.opts.decimate)).info->dset;
+    attr_string(every, "hdaq_source", key);
+    attr_string(every, "hdaq_reduction", "decimate");
+    every.createAttribute("hdaq_factor", h5type<uint64_t>::get(), H5::DataSpace())
+      .write(h5type<uint64_t>::get(), &factor);
+    dset.createAttribute("hdaq_decimate", h5type<uint64_t>::get(), H5::DataSpace())
+      .write(h5type<uint64_t>::get(), &factor);
+  }
+
+  std::vector<uint64_t> factors;
+  for (const size_t f : red.opts.levels) {
+    factors.push_back(f);
+    for (const char* stat : stats) {
+      const std::string name = key + "_" + stat + "_" + std::to_string(f);
+      const uint64_t factor = f;
+      const H5::DataSet level =
+        create_dataset<double>(name, size, scaled(f)).info->dset;
+      attr_string(level, "hdaq_source", key);
+      attr_string(level, "hdaq_reduction", stat);
+      level.createAttribute("hdaq_factor", h5type<uint64_t>::get(), H5::DataSpace())
+        .write(h5type<uint64_t>::get(), &factor);
+    }
+  }
+  if (!factors.empty()) {
+    const hsize_t n = factors.size();
+    dset.createAttribute("hdaq_levels", h5type<uint64_t>::get(), H5::DataSpace(1, &n))
+      .write(h5type<uint64_t>::get(), factors.data());
+  }
+
+  reduce_attach(key, red);
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::reduce_attach(const std::string& key, reduction& red) {
+
+  const std::unordered_map<std::string, dset_info>::iterator raw =
+    map_dset.find(key);
+  if (raw == map_dset.end()) return;
+  const H5T_class_t cls = raw->second.type.getClass();
+  if (!red.opts.levels.empty() && cls != H5T_INTEGER && cls != H5T_FLOAT) {
+    throw std::runtime_error("reduction levels require arithmetic records");
+  }
+  raw->second.reduce = nullptr;
+
+  auto find = [this](const std::string& name) -> dset_info* {
+    const std::unordered_map<std::string, dset_info>::iterator it =
+      map_dset.find(name);
+    return it == map_dset.end()? nullptr : &it->second;
+  };
+
+  // after a resume, decimation and blocks continue from the records on disk
+  red.nrec = raw->second.nrec + raw->second.nstaged;
+  red.decimated = nullptr;
+  if (red.opts.decimate) {
+    red.decimated = find(key + "_every_" + std::to_string(red.opts.decimate));
+    if (!red.decimated) return;
+  }
+
+  const char* stats[] = {"min", "max", "mean", "rms"};
+  red.levels.clear();
+  for (const size_t f : red.opts.levels) {
+    reduction_level level;
+    level.factor = f;
+    for (size_t i = 0; i < level.dsets.size(); i++) {
+      level.dsets[i] = find(key + "_" + stats[i] + "_" + std::to_string(f));
+      if (!level.dsets[i]) return;
+    }
+    level.min.resize(raw->second.size);
+    level.max.resize(raw->second.size);
+    level.sum.resize(raw->second.size);
+    level.sumsq.resize(raw->second.size);
+    reduce_reset(level);
+    red.levels.push_back(level);
+  }
+  red.mean.resize(raw->second.size);
+  red.rms.resize(raw->second.size);
+
+  if (!red.levels.empty()) reduce_replay(raw->second, red);
+
+  raw->second.reduce = &red;
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::reduce_replay(const dset_info& raw, reduction& red) {
+
+  const size_t last = red.nrec;
+  const size_t first = last - last % red.levels.back().factor;
+  const size_t batch = std::max<size_t>(
+    1, (1 << 20) / std::max<size_t>(1, raw.size * sizeof(double))
+  );
+  std::vector<double> buf(batch * raw.size);
+
+  for (size_t r = first; r < last; r += batch) {
+    const size_t count = std::min(batch, last - r);
+    const std::array<hsize_t,2> offs = dset_shape(raw, r, 0);
+    const std::array<hsize_t,2> dims = dset_shape(raw, count, raw.size);
+    H5::DataSpace fspace = raw.dset.getSpace();
+    fspace.selectHyperslab(H5S_SELECT_SET, dims.data(), offs.data());
+    H5::DataSpace mspace(dims.size(), dims.data());
+    raw.dset.read(buf.data(), H5::PredType::NATIVE_DOUBLE, mspace, fspace);
+
+    for (size_t i = 0; i < count; i++) {
+      red.nrec = r + i;
+      const hdaq::view<double> vec =
+        raw.layout == hdaq::layout::record_major?
+        hdaq::view<double>(buf.data() + i * raw.size, raw.size) :
+        hdaq::view<double>(buf.data() + i, raw.size, count);
+      reduce_accumulate<double>(vec, red, std::true_type());
+    }
+  }
+  red.nrec = last;
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+void
+hdaq::interface::reduce_update(const hdaq::view<T>& vec, reduction& red) {
+
+  if (red.decimated && red.nrec % red.opts.decimate == 0) {
+    dset_append<T>(vec, *red.decimated);
+    swmr_update(*red.decimated);
+  }
+  reduce_accumulate<T>(vec, red, std::is_arithmetic<T>());
+  red.nrec++;
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+void
+hdaq::interface::reduce_accumulate(
+  const hdaq::view<T>& vec,
+  reduction& red,
+  std::true_type
+) {
+
+  if (red.levels.empty()) return;
+
+  // blocks cover records [kF, (k+1)F); a stage is only fed from a boundary
+  reduction_level& level = red.levels[0];
+  if (level.count == 0 && red.nrec % level.factor) return;
+
+  const size_t n = vec.size();
+  const size_t stride = vec.stride();
+  const T* x = vec.data();
+  double* mn = level.min.data();
+  double* mx = level.max.data();
+  double* sum = level.sum.data();
+  double* sq = level.sumsq.data();
+
+  // branch-free body, vectorized by the compiler for contiguous records
+  if (stride == 1) {
+    for (size_t i = 0; i < n; i++) {
+      const double v = static_cast<double>(x[i]);
+      mn[i] = v < mn[i]? v : mn[i];
+      mx[i] = v > mx[i]? v : mx[i];
+      sum[i] += v;
+      sq[i] += v * v;
+    }
+  } else {
+    for (size_t i = 0; i < n; i++) {
+      const double v = static_cast<double>(x[i * stride]);
+      mn[i] = v < mn[i]? v : mn[i];
+      mx[i] = v > mx[i]? v : mx[i];
+      sum[i] += v;
+      sq[i] += v * v;
+    }
+  }
+
+  level.count++;
+  reduce_carry(red, 0);
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+void
+hdaq::interface::reduce_accumulate(
+  const hdaq::view<T>&,
+  reduction&,
+  std::false_type
+) {}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::reduce_carry(reduction& red, const size_t i) {
+
+  reduction_level& level = red.levels[i];
+  if (level.count < level.factor) return;
+
+  const size_t n = level.sum.size();
+  const double scale = 1.0 / level.count;
+  for (size_t k = 0; k < n; k++) {
+    red.mean[k] = level.sum[k] * scale;
+    red.rms[k] = std::sqrt(level.sumsq[k] * scale);
+  }
+  // blocks replayed after a resume may already be on disk
+  const size_t block = (red.nrec + 1 - level.count) / level.factor;
+  if (block >= level.dsets[0]->nrec + level.dsets[0]->nstaged) {
+    dset_append<double>(hdaq::view<double>(level.min), *level.dsets[0]);
+    dset_append<double>(hdaq::view<double>(level.max), *level.dsets[1]);
+    dset_append<double>(hdaq::view<double>(red.mean), *level.dsets[2]);
+    dset_append<double>(hdaq::view<double>(red.rms), *level.dsets[3]);
+    for (dset_info* info : level.dsets) swmr_update(*info);
+  }
+
+  if (i + 1 < red.levels.size()) {
+    reduction_level& next = red.levels[i + 1];
+    for (size_t k = 0; k < n; k++) {
+      next.min[k] = level.min[k] < next.min[k]? level.min[k] : next.min[k];
+      next.max[k] = level.max[k] > next.max[k]? level.max[k] : next.max[k];
+      next.sum[k] += level.sum[k];
+      next.sumsq[k] += level.sumsq[k];
+    }
+    next.count += level.count;
+    reduce_reset(level);
+    reduce_carry(red, i + 1);
+  } else {
+    reduce_reset(level);
+  }
+
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::reduce_reset(reduction_level& level) {
+  std::fill(level.min.begin(), level.min.end(),
+    std::numeric_limits<double>::infinity());
+  std::fill(level.max.begin(), level.max.end(),
+    -std::numeric_limits<double>::infinity());
+  std::fill(level.sum.begin(), level.sum.end(), 0.0);
+  std::fill(level.sumsq.begin(), level.sumsq.end(), 0.0);
+  level.count = 0;
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::attr_string(
+  const H5::DataSet& dset,
+  const std::string& name,
+  const std::string& value
+) {
+  const H5::StrType type(H5::PredType::C_S1, std::max<size_t>(1, value.size()));
+  dset.createAttribute(name, type, H5::DataSpace()).write(type, value);
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+void
+hdaq::interface::attr_insert(
+  const class attribute<T>& attr,
+  const std::string& fname
+) {
+
+  const std::pair<std::string, std::string> pathname = get_h5pathname(fname);
+  const std::string name = pathname.first + pathname.second;
+  const std::unordered_map<std::string, dset_info>::iterator it =
+    map_dset.find(name);
+  if(it == map_dset.end()) {
+    throw std::runtime_error("dataset not found");
+  }
+
+  const std::array<hsize_t, 1> dims{{attr.size()}};
+
+  H5::DataSet& dset = it->second.dset;
+  H5::DataSpace adspace(1, dims.data());
+
+  H5::Attribute md = dset.createAttribute(
+    attr.name(), h5type<T>::get(), adspace
+  );
+  md.write(h5type<T>::get(), attr.data());
 
 }
 
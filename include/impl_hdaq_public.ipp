@@ -4,46 +4,191 @@
 
 /* ------------------------------------------------------------------------- */
 
-hdaq::interface::interface() :
-  file(get_h5fname(""), H5F_ACC_TRUNC)
+inline hdaq::interface::interface() :
+  file(file_create(get_h5fname(""), file_options())), default_buffer(),
+  fopts(), fbase(""),
+  nerrors(0), stats_sink(), stats_period(0),
+  stats_last(std::chrono::steady_clock::now()), roll(), roll_enabled(false),
+  roll_seq(0), roll_bytes(0), roll_records(0),
+  roll_start(std::chrono::steady_clock::now()), swmr(), swmr_enabled(false),
+  ckpt(), ckpt_enabled(false), ckpt_records(0),
+  ckpt_last(std::chrono::steady_clock::now()), ckpt_written(false),
+  generation(0)
 {}
 
 /* ------------------------------------------------------------------------- */
 
-hdaq::interface::interface(const std::string& fname) :
-  file(get_h5fname(fname), H5F_ACC_TRUNC) 
+inline hdaq::interface::interface(
+  const std::string& fname,
+  const file_options& opts
+) :
+  file(file_create(get_h5fname(fname), opts)), default_buffer(), fopts(opts),
+  fbase(fname),
+  nerrors(0), stats_sink(), stats_period(0),
+  stats_last(std::chrono::steady_clock::now()), roll(), roll_enabled(false),
+  roll_seq(0), roll_bytes(0), roll_records(0),
+  roll_start(std::chrono::steady_clock::now()), swmr(), swmr_enabled(false),
+  ckpt(), ckpt_enabled(false), ckpt_records(0),
+  ckpt_last(std::chrono::steady_clock::now()), ckpt_written(false),
+  generation(0)
 {}
 
 /* ------------------------------------------------------------------------- */
 
-void hdaq::interface::set_filename(const std::string& fname) {
+inline hdaq::interface::~interface() {
+  try {
+    H5::Exception::dontPrint();
+    for (auto& kv : map_dset) dset_flush(kv.second);
+    if (ckpt_enabled || ckpt_written) checkpoint();
+    roll_discard();
+    HDAQ_STATS(if (stats_sink) stats_sink(stats());)
+  } catch (H5::Exception error) {
+    error.printErrorStack();
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void hdaq::interface::set_filename(
+  const std::string& fname,
+  const file_options& opts
+) {
   if (file.getId() != H5I_BADID) {
+    flush();
+    if (ckpt_enabled || ckpt_written) checkpoint();
+    roll_discard();
+    map_group.clear();
+    map_dset.clear();
+    generation++;
     file.close();
   }
-  file.openFile(get_h5fname(fname), H5F_ACC_RDWR);
+
+  const std::string name = fname + ".h5";
+  if (!std::ifstream(name).is_open()) file_create(name, opts).close();
+  file.openFile(name, H5F_ACC_RDWR, file_fapl(opts));
+  swmr_enabled = false;
+  ckpt_records = 0;
+  ckpt_last = std::chrono::steady_clock::now();
+  ckpt_written = false;
+  file_discover(file.openGroup("/"), "/");
+  try {
+    for (auto& kv : map_reduce) reduce_attach(kv.first, kv.second);
+  } catch (...) {
+    // a dataset left without its reduction stage must not be appended to
+    map_group.clear();
+    map_dset.clear();
+    generation++;
+    file.close();
+    throw;
+  }
+  // the truncated extents become the new checkpoint right away, so a crash
+  // before the next periodic one is still recovered from
+  if (ckpt_written) checkpoint();
+  fopts = opts;
+  fbase = fname;
+  roll_seq = 0;
+  roll_bytes = 0;
+  roll_records = 0;
+  roll_start = std::chrono::steady_clock::now();
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+hdaq::handle<T>
+hdaq::interface::open_dataset(const std::string& name) {
+  const std::pair<std::string, std::string> pathname = get_h5pathname(name);
+  const std::unordered_map<std::string, dset_info>::iterator it =
+    map_dset.find(pathname.first + pathname.second);
+  if (it == map_dset.end()) {
+    throw std::runtime_error("dataset not found");
+  }
+  if (!(h5type<T>::get() == it->second.type)) {
+    throw std::runtime_error("dataset is not of the handle type");
+  }
+  return handle<T>(this, &it->second);
 }
 
 /* ------------------------------------------------------------------------- */
 
 template <typename T>
 void 
-hdaq::interface::insert(const class dataset<T>& vec, const std::string& fname) {
-  const std::pair<std::string, std::string> pathname = get_h5pathname(fname);
-  const std::string path = pathname.first;
-  const std::string name = pathname.second;
-  (void)path;
+hdaq::interface::insert(
+  const class dataset<T>& vec,
+  const std::string& fname,
+  const dataset_options& opts
+) {
+  insert(view<T>(vec), fname, opts);
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+void 
+hdaq::interface::insert(
+  const class view<T>& vec,
+  const std::string& fname,
+  const dataset_options& opts
+) {
   try {
     H5::Exception::dontPrint();
-    if(map_dset.find(name) == map_dset.end()) {
-      dset_write<T>(vec, name);
-    } else {
-      dset_append<T>(vec, name);
-    }
+    dset_insert<T>(vec, fname, opts);
   } catch (H5::FileIException error) {
+    nerrors++;
+    error.printErrorStack();
+  } catch (H5::GroupIException error) {
+    nerrors++;
     error.printErrorStack();
   } catch (H5::DataSetIException error) {
+    nerrors++;
     error.printErrorStack();
   } catch (H5::DataSpaceIException error) {
+    nerrors++;
+    error.printErrorStack();
+  } catch (H5::AttributeIException error) {
+    nerrors++;
+    error.printErrorStack();
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+void 
+hdaq::interface::insert(const class dataset<T>& vec, const handle<T>& dset) {
+  insert(view<T>(vec), dset);
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+void 
+hdaq::interface::insert(const class view<T>& vec, const handle<T>& dset) {
+  if (!dset.valid() || dset.owner != this) {
+    throw std::runtime_error("invalid dataset handle");
+  }
+  try {
+    H5::Exception::dontPrint();
+    dset_append<T>(vec, *dset.info);
+    if (dset.info->reduce) reduce_update<T>(vec, *dset.info->reduce);
+    swmr_update(*dset.info);
+    roll_update(*dset.info);
+    checkpoint_update();
+    HDAQ_STATS(stats_update();)
+  } catch (H5::FileIException error) {
+    nerrors++;
+    error.printErrorStack();
+  } catch (H5::GroupIException error) {
+    nerrors++;
+    error.printErrorStack();
+  } catch (H5::DataSetIException error) {
+    nerrors++;
+    error.printErrorStack();
+  } catch (H5::DataSpaceIException error) {
+    nerrors++;
+    error.printErrorStack();
+  } catch (H5::AttributeIException error) {
+    nerrors++;
     error.printErrorStack();
   }
 }
@@ -55,28 +200,86 @@ void
 hdaq::interface::insert(
   const class attribute<T>& attr,
   const std::string& fname
+) {
+  try {
+    H5::Exception::dontPrint();
+    attr_insert<T>(attr, fname);
+  } catch (H5::FileIException error) {
+    error.printErrorStack();
+  } catch (H5::DataSetIException error) {
+    error.printErrorStack();
+  } catch (H5::DataSpaceIException error) {
+    error.printErrorStack();
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::set_buffer(
+  const std::string& fname,
+  const size_t records,
+  const size_t bytes
 ) {
   const std::pair<std::string, std::string> pathname = get_h5pathname(fname);
-  const std::string path = pathname.first;
-  const std::string name = pathname.second;
-  (void)path;
+  const std::string name = pathname.first + pathname.second;
+  buffer_policy& policy = map_buffer[name];
+  policy.records = records;
+  policy.bytes = bytes;
 
   try {
     H5::Exception::dontPrint();
-    if(map_dset.find(name) == map_dset.end()) {
-      throw std::runtime_error("dataset not found");
+    const std::unordered_map<std::string, dset_info>::iterator it =
+      map_dset.find(name);
+    if (it != map_dset.end()) dset_buffer(it->second, policy);
+  } catch (H5::DataSetIException error) {
+    error.printErrorStack();
+  } catch (H5::DataSpaceIException error) {
+    error.printErrorStack();
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::set_reduction(
+  const std::string& fname,
+  const reduction_options& opts
+) {
+  for (size_t i = 0; i < opts.levels.size(); i++) {
+    if (opts.levels[i] < 2 || (i && opts.levels[i] % opts.levels[i - 1])) {
+      throw std::runtime_error(
+        "reduction levels must increase, each a multiple of the previous"
+      );
     }
+  }
 
-    const std::array<hsize_t, 1> dims{{attr.size()}};
+  const std::pair<std::string, std::string> pathname = get_h5pathname(fname);
+  const std::string name = pathname.first + pathname.second;
+  if (map_dset.find(name) != map_dset.end()) {
+    throw std::runtime_error("reduction must be set before the dataset is created");
+  }
+  reduction& red = map_reduce[name];
+  red.opts = opts;
+  red.nrec = 0;
+  red.decimated = nullptr;
+}
 
-    H5::DataSet& dset = map_dset[fname];
-    H5::DataSpace adspace(1, dims.data());
+/* ------------------------------------------------------------------------- */
 
-    H5::Attribute md = dset.createAttribute(
-      attr.name(), get_h5type<T>(), adspace
-    );
-    md.write(get_h5type<T>(), attr.data());
+inline void
+hdaq::interface::set_buffer(const size_t records, const size_t bytes) {
+  default_buffer.records = records;
+  default_buffer.bytes = bytes;
+}
+
+/* ------------------------------------------------------------------------- */
 
+inline void
+hdaq::interface::flush() {
+  try {
+    H5::Exception::dontPrint();
+    file_flush();
   } catch (H5::FileIException error) {
     error.printErrorStack();
   } catch (H5::DataSetIException error) {
@@ -86,6 +289,163 @@ hdaq::interface::insert(
   }
 }
 
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::flush(const std::string& fname) {
+  const std::pair<std::string, std::string> pathname = get_h5pathname(fname);
+  const std::string name = pathname.first + pathname.second;
+  try {
+    H5::Exception::dontPrint();
+    const std::unordered_map<std::string, dset_info>::iterator it =
+      map_dset.find(name);
+    if (it != map_dset.end()) dset_flush(it->second);
+  } catch (H5::DataSetIException error) {
+    error.printErrorStack();
+  } catch (H5::DataSpaceIException error) {
+    error.printErrorStack();
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::set_rollover(const rollover_options& opts) {
+  const bool enabled =
+    opts.max_bytes || opts.max_records || opts.interval.count();
+  if (enabled && fbase.empty()) {
+    throw std::runtime_error("rollover requires a file name");
+  }
+  roll = opts;
+  roll_enabled = enabled;
+  try {
+    H5::Exception::dontPrint();
+    if (!roll_enabled) roll_discard();
+  } catch (H5::FileIException error) {
+    error.printErrorStack();
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::set_checkpoint(const checkpoint_options& opts) {
+  ckpt = opts;
+  ckpt_enabled = opts.records || opts.interval.count();
+  ckpt_records = 0;
+  ckpt_last = std::chrono::steady_clock::now();
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::checkpoint() {
+  try {
+    H5::Exception::dontPrint();
+    for (auto& kv : map_dset) {
+      dset_info& info = kv.second;
+      dset_flush(info);
+      if (swmr_enabled) continue;
+
+      const uint64_t nrec = info.nrec;
+      if (!info.dset.attrExists("hdaq_checkpoint")) {
+        info.dset.createAttribute(
+          "hdaq_checkpoint", h5type<uint64_t>::get(), H5::DataSpace()
+        );
+      }
+      info.dset.openAttribute("hdaq_checkpoint").write(
+        h5type<uint64_t>::get(), &nrec
+      );
+    }
+    if (!swmr_enabled) ckpt_written = true;
+    file.flush(H5F_SCOPE_LOCAL);
+  } catch (H5::FileIException error) {
+    error.printErrorStack();
+  } catch (H5::DataSetIException error) {
+    error.printErrorStack();
+  } catch (H5::DataSpaceIException error) {
+    error.printErrorStack();
+  } catch (H5::AttributeIException error) {
+    error.printErrorStack();
+  }
+  ckpt_records = 0;
+  ckpt_last = std::chrono::steady_clock::now();
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::start_swmr(const swmr_options& opts) {
+  if (!fopts.latest_format) {
+    throw std::runtime_error("SWMR requires file_options::latest_format");
+  }
+  swmr = opts;
+  try {
+    H5::Exception::dontPrint();
+    if (!swmr_enabled) {
+      for (auto& kv : map_dset) {
+        dset_flush(kv.second);
+        if (ckpt_written && kv.second.dset.attrExists("hdaq_checkpoint")) {
+          kv.second.dset.removeAttr("hdaq_checkpoint");
+        }
+      }
+      ckpt_written = false;
+      if (H5Fstart_swmr_write(file.getId()) < 0) {
+        throw std::runtime_error("failed to start SWMR write");
+      }
+      swmr_enabled = true;
+    }
+    for (auto& kv : map_dset) {
+      kv.second.swmr_count = 0;
+      kv.second.swmr_last = std::chrono::steady_clock::now();
+    }
+  } catch (H5::DataSetIException error) {
+    error.printErrorStack();
+  } catch (H5::DataSpaceIException error) {
+    error.printErrorStack();
+  } catch (H5::AttributeIException error) {
+    error.printErrorStack();
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline const hdaq::stats_report
+hdaq::interface::stats() {
+  stats_report report;
+  report.mdc_hit_rate = 0;
+  report.mdc_size = 0;
+  report.mdc_entries = 0;
+  size_t max_size = 0;
+  size_t min_clean = 0;
+  H5Fget_mdc_hit_rate(file.getId(), &report.mdc_hit_rate);
+  H5Fget_mdc_size(
+    file.getId(), &max_size, &min_clean, &report.mdc_size, &report.mdc_entries
+  );
+  report.errors = nerrors;
+  for (const auto& kv : map_dset) report.datasets[kv.first] = kv.second.stats;
+  return report;
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::interface::set_stats_sink(
+  const std::function<void(const stats_report&)>& sink,
+  const std::chrono::milliseconds period
+) {
+  stats_sink = sink;
+  stats_period = period;
+  stats_last = std::chrono::steady_clock::now();
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline const std::string
+hdaq::interface::filename() const {
+  return file.getFileName();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// End
 ///////////////////////////////////////////////////////////////////////////////
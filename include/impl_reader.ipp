@@ -0,0 +1,398 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Reader Public Methods Implementations
+///////////////////////////////////////////////////////////////////////////////
+
+inline hdaq::reader::reader(const std::string& fname, const bool swmr) :
+  file(fname, swmr? H5F_ACC_RDONLY | H5F_ACC_SWMR_READ : H5F_ACC_RDONLY)
+{
+  H5::Exception::dontPrint();
+  discover(file.openGroup("/"), "/");
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline size_t
+hdaq::reader::refresh(const std::string& name) {
+  dset_entry& info = entry(name);
+  if (H5Drefresh(info.dset.getId()) < 0) {
+    throw std::runtime_error("dataset refresh failed");
+  }
+  std::array<hsize_t,2> dims{{}};
+  info.dset.getSpace().getSimpleExtentDims(dims.data());
+  info.nrec = info.layout == hdaq::layout::record_major? dims[0] : dims[1];
+  return info.nrec;
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline const std::vector<std::string>
+hdaq::reader::datasets() const {
+  std::vector<std::string> names;
+  for (const auto& kv : map_dset) names.push_back(kv.first);
+  return names;
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline const std::vector<std::string>
+hdaq::reader::attributes(const std::string& name) const {
+  const H5::DataSet& dset = entry(name).dset;
+  std::vector<std::string> names;
+  const int n = dset.getNumAttrs();
+  for (int i = 0; i < n; i++) {
+    names.push_back(dset.openAttribute(static_cast<unsigned int>(i)).getName());
+  }
+  return names;
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+hdaq::attribute<T>
+hdaq::reader::read_attribute(
+  const std::string& name,
+  const std::string& attr
+) const {
+  const H5::Attribute md = entry(name).dset.openAttribute(attr);
+  const hssize_t n = md.getSpace().getSimpleExtentNpoints();
+  class attribute<T> out(attr, static_cast<size_t>(n));
+  md.read(h5type<T>::get(), out.data());
+  return out;
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline size_t
+hdaq::reader::records(const std::string& name) const {
+  return entry(name).nrec;
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline size_t
+hdaq::reader::size(const std::string& name) const {
+  return entry(name).size;
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline size_t
+hdaq::reader::chunk_records(const std::string& name) const {
+  return entry(name).chunk;
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline hdaq::layout
+hdaq::reader::layout(const std::string& name) const {
+  return entry(name).layout;
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline const H5::DataSet&
+hdaq::reader::dataset(const std::string& name) const {
+  return entry(name).dset;
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+void
+hdaq::reader::read(
+  const std::string& name,
+  const size_t first,
+  const size_t count,
+  T* buf
+) const {
+  read<T>(name, first, count, 0, entry(name).size, buf);
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+void
+hdaq::reader::read(
+  const std::string& name,
+  const size_t first,
+  const size_t count,
+  const size_t efirst,
+  const size_t ecount,
+  T* buf
+) const {
+  const dset_entry& info = entry(name);
+  if (first + count > info.nrec || efirst + ecount > info.size) {
+    throw std::runtime_error("read out of dataset bounds");
+  }
+  if (!count || !ecount) return;
+
+  const bool rm = info.layout == hdaq::layout::record_major;
+  const std::array<hsize_t,2> dims = rm?
+    std::array<hsize_t,2>{{info.nrec, info.size}} :
+    std::array<hsize_t,2>{{info.size, info.nrec}};
+  const std::array<hsize_t,2> offs = rm?
+    std::array<hsize_t,2>{{first, efirst}} :
+    std::array<hsize_t,2>{{efirst, first}};
+  const std::array<hsize_t,2> cnt = rm?
+    std::array<hsize_t,2>{{count, ecount}} :
+    std::array<hsize_t,2>{{ecount, count}};
+
+  H5::DataSpace fspace(dims.size(), dims.data());
+  fspace.selectHyperslab(H5S_SELECT_SET, cnt.data(), offs.data());
+  const hsize_t n = count * ecount;
+  H5::DataSpace memspace(1, &n);
+
+  if (rm) {
+    info.dset.read(buf, h5type<T>::get(), memspace, fspace);
+    return;
+  }
+
+  std::vector<T> scratch(n);
+  info.dset.read(scratch.data(), h5type<T>::get(), memspace, fspace);
+  for (size_t c = 0; c < ecount; c++) {
+    const T* row = scratch.data() + c * count;
+    for (size_t r = 0; r < count; r++) buf[r * ecount + c] = row[r];
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Reader Private Methods Implementations
+///////////////////////////////////////////////////////////////////////////////
+
+inline void
+hdaq::reader::discover(const H5::Group& group, const std::string& path) {
+  const hsize_t n = group.getNumObjs();
+  for (hsize_t i = 0; i < n; i++) {
+    const std::string name = group.getObjnameByIdx(i);
+    const H5O_type_t type = group.childObjType(name);
+
+    if (type == H5O_TYPE_GROUP) {
+      discover(group.openGroup(name), path + name + "/");
+      continue;
+    }
+    if (type != H5O_TYPE_DATASET) continue;
+
+    dset_entry info;
+    info.dset = group.openDataSet(name);
+    const H5::DataSpace dspace = info.dset.getSpace();
+    if (dspace.getSimpleExtentNdims() != 2) continue;
+
+    std::array<hsize_t,2> dims{{}};
+    std::array<hsize_t,2> maxdims{{}};
+    dspace.getSimpleExtentDims(dims.data(), maxdims.data());
+    const bool rm = maxdims[0] == H5S_UNLIMITED && maxdims[1] != H5S_UNLIMITED;
+    info.layout = rm? hdaq::layout::record_major : hdaq::layout::channel_major;
+    info.nrec = rm? dims[0] : dims[1];
+    info.size = rm? dims[1] : dims[0];
+
+    info.chunk = 1;
+    const H5::DSetCreatPropList plist = info.dset.getCreatePlist();
+    if (plist.getLayout() == H5D_CHUNKED) {
+      std::array<hsize_t,2> chunkdims{{}};
+      plist.getChunk(chunkdims.size(), chunkdims.data());
+      info.chunk = rm? chunkdims[0] : chunkdims[1];
+    }
+
+    map_dset[path + name] = info;
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline const hdaq::reader::dset_entry&
+hdaq::reader::entry(const std::string& name) const {
+  const std::map<std::string, dset_entry>::const_iterator it =
+    map_dset.find(name.size() && name[0] == '/'? name : "/" + name);
+  if (it == map_dset.end()) {
+    throw std::runtime_error("dataset not found");
+  }
+  return it->second;
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline hdaq::reader::dset_entry&
+hdaq::reader::entry(const std::string& name) {
+  return const_cast<dset_entry&>(
+    static_cast<const reader&>(*this).entry(name)
+  );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Stream Implementations
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+hdaq::stream<T>::iterator::iterator(stream<T>* s) : src(s) {}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+const typename hdaq::stream<T>::batch&
+hdaq::stream<T>::iterator::operator*() const {
+  return src->current();
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+const typename hdaq::stream<T>::batch*
+hdaq::stream<T>::iterator::operator->() const {
+  return &src->current();
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+typename hdaq::stream<T>::iterator&
+hdaq::stream<T>::iterator::operator++() {
+  if (!src->next()) src = nullptr;
+  return *this;
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+bool
+hdaq::stream<T>::iterator::operator==(const iterator& other) const {
+  return src == other.src;
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+bool
+hdaq::stream<T>::iterator::operator!=(const iterator& other) const {
+  return src != other.src;
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+hdaq::stream<T>::stream(
+  const reader& src,
+  const std::string& name,
+  const size_t nbatch
+) :
+  src(src),
+  name(name),
+  size(src.size(name)),
+  total(src.records(name)),
+  nbatch(src.chunk_records(name)),
+  pos(0),
+  front(),
+  back(),
+  cur(),
+  ahead(),
+  pending()
+{
+  if (nbatch > this->nbatch) {
+    this->nbatch *= (nbatch + this->nbatch - 1) / this->nbatch;
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+hdaq::stream<T>::~stream() {
+  if (pending.valid()) pending.wait();
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+bool
+hdaq::stream<T>::next() {
+  if (!pending.valid() && pos == 0) prefetch();
+  if (!pending.valid()) return false;
+
+  pending.get();
+  std::swap(front, back);
+  cur = ahead;
+  cur.data = front.data();
+  prefetch();
+  return true;
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+const typename hdaq::stream<T>::batch&
+hdaq::stream<T>::current() const {
+  return cur;
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+typename hdaq::stream<T>::iterator
+hdaq::stream<T>::begin() {
+  return iterator(next()? this : nullptr);
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+typename hdaq::stream<T>::iterator
+hdaq::stream<T>::end() {
+  return iterator(nullptr);
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+void
+hdaq::stream<T>::prefetch() {
+  if (pos >= total) return;
+
+  ahead.first = pos;
+  ahead.count = std::min(nbatch, total - pos);
+  ahead.size = size;
+  pos += ahead.count;
+  back.resize(ahead.count * size);
+
+  // without a thread-safe library the read is deferred to `next`
+  const std::launch policy =
+#ifdef H5_HAVE_THREADSAFE
+    std::launch::async;
+#else
+    std::launch::deferred;
+#endif
+  pending = std::async(policy, [this]() {
+    src.read<T>(name, ahead.first, ahead.count, back.data());
+  });
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Tail Implementations
+///////////////////////////////////////////////////////////////////////////////
+
+inline hdaq::tail::tail(reader& src, const std::string& name, const size_t first) :
+  src(src), name(name), pos(first)
+{}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+size_t
+hdaq::tail::poll(std::vector<T>& out, const size_t max) {
+  const size_t total = src.refresh(name);
+  size_t count = total > pos? total - pos : 0;
+  if (max) count = std::min(count, max);
+
+  out.resize(count * src.size(name));
+  if (count) src.read<T>(name, pos, count, out.data());
+  pos += count;
+  return count;
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline size_t
+hdaq::tail::position() const {
+  return pos;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// End
+///////////////////////////////////////////////////////////////////////////////
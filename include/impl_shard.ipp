@@ -0,0 +1,154 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Sharding Implementations
+///////////////////////////////////////////////////////////////////////////////
+
+/* ------------------------------------------------------------------------- */
+
+inline size_t
+hdaq::shard_rank() {
+  for (const char* var : {"OMPI_COMM_WORLD_RANK", "PMI_RANK", "SLURM_PROCID"}) {
+    const char* value = std::getenv(var);
+    if (value) return std::strtoul(value, nullptr, 10);
+  }
+  return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline size_t
+hdaq::shard_count() {
+  for (const char* var : {"OMPI_COMM_WORLD_SIZE", "PMI_SIZE", "SLURM_NTASKS"}) {
+    const char* value = std::getenv(var);
+    if (value) return std::max<size_t>(1, std::strtoul(value, nullptr, 10));
+  }
+  return 1;
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline const std::string
+hdaq::shard_name(const std::string& base, const size_t index) {
+  char suffix[32];
+  std::snprintf(suffix, sizeof(suffix), "_shard%04zu", index);
+  return base + suffix;
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::merge_shards(
+  const std::string& master,
+  const std::vector<std::string>& shards
+) {
+
+  struct source {
+    std::string file; ///< Shard file, relative to the master file if possible.
+    hsize_t first;    ///< First record within the virtual dataset.
+    hsize_t nrec;     ///< Number of records in the shard.
+  };
+
+  struct target {
+    H5::DataType type;           ///< Data type of the elements.
+    hdaq::layout layout;         ///< Orientation of the records.
+    hsize_t size;                ///< Number of elements per record.
+    hsize_t nrec;                ///< Total number of records.
+    H5::DataSet origin;          ///< Dataset the attributes are taken from.
+    std::vector<source> sources; ///< Shards holding records.
+  };
+
+  // Source files are stored relative to the master directory, so the set
+  // can be moved as a whole.
+  const size_t split = master.find_last_of('/');
+  const std::string dir = split == std::string::npos?
+    "" : master.substr(0, split + 1);
+
+  std::map<std::string, target> targets;
+  for (const std::string& shard : shards) {
+    const reader src(shard);
+    const bool local = !dir.empty() && shard.compare(0, dir.size(), dir) == 0
+      && shard.find('/', dir.size()) == std::string::npos;
+    const std::string file = local? shard.substr(dir.size()) : shard;
+
+    for (const std::string& name : src.datasets()) {
+      const H5::DataType type = src.dataset(name).getDataType();
+      const std::map<std::string, target>::iterator it = targets.find(name);
+      if (it == targets.end()) {
+        const target dst{
+          type, src.layout(name), src.size(name), 0, src.dataset(name),
+          std::vector<source>()
+        };
+        targets.emplace(name, dst);
+      } else if (
+        !(it->second.type == type) || it->second.layout != src.layout(name) ||
+        it->second.size != src.size(name)
+      ) {
+        throw std::runtime_error("shard layout mismatch: " + name);
+      }
+
+      target& dst = targets.find(name)->second;
+      if (src.records(name) == 0) continue;
+      dst.sources.push_back(source{file, dst.nrec, src.records(name)});
+      dst.nrec += src.records(name);
+    }
+  }
+
+  // the master is written under a temporary name, so that a failed merge
+  // never leaves a partial master behind
+  const std::string tmp = master + ".tmp";
+  H5::Exception::dontPrint();
+  try {
+    H5::H5File file(tmp, H5F_ACC_TRUNC);
+    H5::LinkCreatPropList lcpl;
+    lcpl.setCreateIntermediateGroup(true);
+
+    for (const auto& kv : targets) {
+      const target& dst = kv.second;
+      const bool rm = dst.layout == hdaq::layout::record_major;
+      const std::array<hsize_t,2> dims{{
+        rm? dst.nrec : dst.size, rm? dst.size : dst.nrec
+      }};
+      const std::array<hsize_t,2> maxdims{{
+        rm? H5S_UNLIMITED : dst.size, rm? dst.size : H5S_UNLIMITED
+      }};
+      H5::DataSpace vspace(dims.size(), dims.data(), maxdims.data());
+
+      H5::DSetCreatPropList plist;
+      for (const source& src : dst.sources) {
+        const std::array<hsize_t,2> count{{
+          rm? src.nrec : dst.size, rm? dst.size : src.nrec
+        }};
+        const std::array<hsize_t,2> offset{{rm? src.first : 0, rm? 0 : src.first}};
+        H5::DataSpace vsel(vspace);
+        vsel.selectHyperslab(H5S_SELECT_SET, count.data(), offset.data());
+        const H5::DataSpace ssel(count.size(), count.data());
+        plist.setVirtual(vsel, src.file, kv.first, ssel);
+      }
+      // without any source the dataset is not virtual; an empty chunked
+      // dataset keeps the unlimited axis that tells readers the layout
+      if (dst.sources.empty()) {
+        const hsize_t size = std::max<hsize_t>(1, dst.size);
+        const std::array<hsize_t,2> chunk{{rm? 1 : size, rm? size : 1}};
+        plist.setChunk(chunk.size(), chunk.data());
+      }
+
+      const H5::DataSet dset = file.createDataSet(
+        kv.first, dst.type, vspace, plist, H5::DSetAccPropList::DEFAULT, lcpl
+      );
+      interface::attr_copy(dst.origin, dset);
+    }
+    file.close();
+  } catch (...) {
+    std::remove(tmp.c_str());
+    throw;
+  }
+
+  if (std::rename(tmp.c_str(), master.c_str()) != 0) {
+    std::remove(tmp.c_str());
+    throw std::runtime_error("failed to rename master file " + master);
+  }
+
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// End
+///////////////////////////////////////////////////////////////////////////////
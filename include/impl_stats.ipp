@@ -0,0 +1,72 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Statistics Implementations
+///////////////////////////////////////////////////////////////////////////////
+
+inline hdaq::histogram::histogram() : buckets(), count(0), total(0), max(0) {}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::histogram::add(const uint64_t ns) {
+  size_t i = 0;
+  for (uint64_t v = ns >> 1; v && i + 1 < buckets.size(); v >>= 1) i++;
+  buckets[i]++;
+  count++;
+  total += ns;
+  if (ns > max) max = ns;
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline uint64_t
+hdaq::histogram::quantile(const double q) const {
+  const double target = q * count;
+  uint64_t seen = 0;
+  for (size_t i = 0; i < buckets.size(); i++) {
+    seen += buckets[i];
+    if (seen && seen >= target) return std::min(max, uint64_t(2) << i);
+  }
+  return max;
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline hdaq::dataset_stats::dataset_stats() :
+  records(0), bytes(0), extends(0), flushes(0), chunks(0), partial_chunks(0)
+{}
+
+/* ------------------------------------------------------------------------- */
+
+inline void
+hdaq::dataset_stats::written(
+  const uint64_t first,
+  const uint64_t count,
+  const uint64_t chunk
+) {
+  if (count == 0 || chunk == 0) return;
+  const uint64_t c0 = first / chunk;
+  const uint64_t c1 = (first + count - 1) / chunk;
+  chunks += c1 - c0 + 1;
+  partial_chunks += (first % chunk != 0) + ((first + count) % chunk != 0);
+  if (c0 == c1 && first % chunk && (first + count) % chunk) partial_chunks--;
+}
+
+/* ------------------------------------------------------------------------- */
+
+inline hdaq::stopwatch::stopwatch() : last(std::chrono::steady_clock::now()) {}
+
+/* ------------------------------------------------------------------------- */
+
+inline uint64_t
+hdaq::stopwatch::lap() {
+  const std::chrono::steady_clock::time_point now =
+    std::chrono::steady_clock::now();
+  const uint64_t ns =
+    std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count();
+  last = now;
+  return ns;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// End
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+hdaq::ring<T>::ring(const size_t capacity) :
+  cells([capacity]() {
+    size_t n = 2;
+    while (n < capacity) n <<= 1;
+    return n;
+  }()),
+  mask(cells.size() - 1),
+  enqueue_pos(0),
+  dequeue_pos(0)
+{
+  for (size_t i = 0; i < cells.size(); i++) {
+    cells[i].seq.store(i, std::memory_order_relaxed);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+bool
+hdaq::ring<T>::push(const T& value, size_t& pos) {
+  pos = enqueue_pos.load(std::memory_order_relaxed);
+  for (;;) {
+    cell& c = cells[pos & mask];
+    const size_t seq = c.seq.load(std::memory_order_acquire);
+    const std::intptr_t diff =
+      static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+    if (diff == 0) {
+      if (enqueue_pos.compare_exchange_weak(
+            pos, pos + 1, std::memory_order_relaxed)) {
+        c.value = value;
+        c.seq.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      return false;
+    } else {
+      pos = enqueue_pos.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+bool
+hdaq::ring<T>::pop(T& value, size_t& pos) {
+  pos = dequeue_pos.load(std::memory_order_relaxed);
+  for (;;) {
+    cell& c = cells[pos & mask];
+    const size_t seq = c.seq.load(std::memory_order_acquire);
+    const std::intptr_t diff =
+      static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+    if (diff == 0) {
+      if (dequeue_pos.compare_exchange_weak(
+            pos, pos + 1, std::memory_order_relaxed)) {
+        value = c.value;
+        c.seq.store(pos + mask + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      return false;
+    } else {
+      pos = dequeue_pos.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+size_t
+hdaq::ring<T>::tail() const {
+  return enqueue_pos.load(std::memory_order_acquire);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+size_t
+hdaq::ring<T>::head() const {
+  return dequeue_pos.load(std::memory_order_acquire);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+size_t
+hdaq::ring<T>::size() const {
+  const size_t deq = head();
+  const size_t enq = tail();
+  // the positions are read at different times, so the difference may
+  // overshoot while both sides advance
+  return std::min(enq > deq ? enq - deq : 0, capacity());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+size_t
+hdaq::ring<T>::capacity() const {
+  return cells.size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
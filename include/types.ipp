@@ -0,0 +1,193 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Fundamental Types
+///////////////////////////////////////////////////////////////////////////////
+
+#define HDAQ_PREDTYPE(ctype, pred)                                           \
+  template <>                                                                \
+  struct hdaq::h5type<ctype> {                                               \
+    static const H5::DataType& get() { return H5::PredType::pred; }          \
+  };
+
+HDAQ_PREDTYPE(bool,               NATIVE_HBOOL)
+HDAQ_PREDTYPE(char,               NATIVE_CHAR)
+HDAQ_PREDTYPE(signed char,        NATIVE_SCHAR)
+HDAQ_PREDTYPE(unsigned char,      NATIVE_UCHAR)
+HDAQ_PREDTYPE(short,              NATIVE_SHORT)
+HDAQ_PREDTYPE(unsigned short,     NATIVE_USHORT)
+HDAQ_PREDTYPE(int,                NATIVE_INT)
+HDAQ_PREDTYPE(unsigned int,       NATIVE_UINT)
+HDAQ_PREDTYPE(long,               NATIVE_LONG)
+HDAQ_PREDTYPE(unsigned long,      NATIVE_ULONG)
+HDAQ_PREDTYPE(long long,          NATIVE_LLONG)
+HDAQ_PREDTYPE(unsigned long long, NATIVE_ULLONG)
+HDAQ_PREDTYPE(float,              NATIVE_FLOAT)
+HDAQ_PREDTYPE(double,             NATIVE_DOUBLE)
+HDAQ_PREDTYPE(long double,        NATIVE_LDOUBLE)
+
+#undef HDAQ_PREDTYPE
+
+///////////////////////////////////////////////////////////////////////////////
+/// Derived Types
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+struct hdaq::h5type<T, typename std::enable_if<std::is_enum<T>::value>::type> :
+  hdaq::h5type<typename std::underlying_type<T>::type> {};
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T>
+struct hdaq::h5type<std::complex<T>> {
+  static const H5::DataType& get() {
+    static const H5::CompType* const type = []() {
+      H5::CompType* t = new H5::CompType(sizeof(std::complex<T>));
+      t->insertMember("r", 0, h5type<T>::get());
+      t->insertMember("i", sizeof(T), h5type<T>::get());
+      return t;
+    }();
+    return *type;
+  }
+};
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T, size_t N>
+struct hdaq::h5type<T[N]> {
+  static const H5::DataType& get() {
+    static const H5::ArrayType* const type = []() {
+      const hsize_t dims = N;
+      return new H5::ArrayType(h5type<T>::get(), 1, &dims);
+    }();
+    return *type;
+  }
+};
+
+/* ------------------------------------------------------------------------- */
+
+template <typename T, size_t N>
+struct hdaq::h5type<std::array<T, N>> : hdaq::h5type<T[N]> {};
+
+/* ------------------------------------------------------------------------- */
+
+template <size_t N>
+struct hdaq::h5type<hdaq::fixed_string<N>> {
+  static const H5::DataType& get() {
+    static const H5::StrType* const type = []() {
+      H5::StrType* t = new H5::StrType(H5::PredType::C_S1, N);
+      t->setStrpad(H5T_STR_NULLPAD);
+      return t;
+    }();
+    return *type;
+  }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Fixed String
+///////////////////////////////////////////////////////////////////////////////
+
+template <size_t N>
+hdaq::fixed_string<N>::fixed_string() : buf() {}
+
+/* ------------------------------------------------------------------------- */
+
+template <size_t N>
+hdaq::fixed_string<N>::fixed_string(const std::string& str) : buf() {
+  std::memcpy(buf, str.data(), std::min(N, str.size()));
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <size_t N>
+hdaq::fixed_string<N>::fixed_string(const char* str) : buf() {
+  std::strncpy(buf, str, N);
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <size_t N>
+std::string
+hdaq::fixed_string<N>::str() const {
+  size_t len = 0;
+  while (len < N && buf[len]) len++;
+  return std::string(buf, len);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Compound
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename S>
+hdaq::compound<S>::compound() : ctype(sizeof(S)) {
+  static_assert(std::is_trivially_copyable<S>::value,
+    "compound types must be trivially copyable");
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename S>
+template <typename M>
+hdaq::compound<S>&
+hdaq::compound<S>::insert(const std::string& name, M S::* member) {
+  typename std::aligned_storage<sizeof(S), alignof(S)>::type storage;
+  const S* base = reinterpret_cast<const S*>(&storage);
+  const size_t offset =
+    reinterpret_cast<const char*>(&(base->*member)) -
+    reinterpret_cast<const char*>(base);
+  ctype.insertMember(name, offset, h5type<M>::get());
+  return *this;
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename S>
+const H5::CompType&
+hdaq::compound<S>::type() const {
+  return ctype;
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename S>
+const H5::DataType&
+hdaq::compound_type<S>::get() {
+  static const H5::CompType* const type = []() {
+    compound<S> c;
+    h5type<S>::describe(c);
+    return new H5::CompType(c.type());
+  }();
+  return *type;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Enumeration
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename E>
+hdaq::enumeration<E>::enumeration() : etype([]() {
+    H5::IntType base;
+    base.copy(h5type<typename std::underlying_type<E>::type>::get());
+    return H5::EnumType(base);
+  }()) {}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename E>
+hdaq::enumeration<E>&
+hdaq::enumeration<E>::insert(const std::string& name, const E value) {
+  typename std::underlying_type<E>::type v =
+    static_cast<typename std::underlying_type<E>::type>(value);
+  etype.insert(name, &v);
+  return *this;
+}
+
+/* ------------------------------------------------------------------------- */
+
+template <typename E>
+const H5::EnumType&
+hdaq::enumeration<E>::type() const {
+  return etype;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// End
+///////////////////////////////////////////////////////////////////////////////
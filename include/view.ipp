@@ -0,0 +1,45 @@
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+hdaq::view<T>::view(const T* data, const size_t size, const size_t stride) :
+  ptr(data), len(size), step(stride) {}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+hdaq::view<T>::view(const std::vector<T>& vec) :
+  ptr(vec.data()), len(vec.size()), step(1) {}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+const T*
+hdaq::view<T>::data() const {
+  return ptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+size_t
+hdaq::view<T>::size() const {
+  return len;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+size_t
+hdaq::view<T>::stride() const {
+  return step;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+const T&
+hdaq::view<T>::operator[](const size_t i) const {
+  return ptr[i * step];
+}
+
+///////////////////////////////////////////////////////////////////////////////
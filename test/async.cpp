@@ -0,0 +1,150 @@
+#include "common.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <thread>
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("ring delivers every element once to concurrent producers", "[ring]") {
+  const int nthreads = 4;
+  const int count = 20000;
+  hdaq::ring<int> queue(64);
+
+  std::vector<std::thread> producers;
+  for (int t = 0; t < nthreads; t++) {
+    producers.emplace_back([&queue, t]() {
+      size_t pos = 0;
+      for (int i = 0; i < count; i++) {
+        while (!queue.push(t * count + i, pos)) std::this_thread::yield();
+      }
+    });
+  }
+
+  std::vector<int> last(nthreads, -1);
+  std::vector<int> seen;
+  size_t prev = 0;
+  while (seen.size() < static_cast<size_t>(nthreads * count)) {
+    int value = 0;
+    size_t pos = 0;
+    if (!queue.pop(value, pos)) continue;
+    // positions are tickets: dequeued in order, and per producer FIFO
+    if (!seen.empty()) REQUIRE(pos == prev + 1);
+    prev = pos;
+    REQUIRE(value % count > last[value / count]);
+    last[value / count] = value % count;
+    seen.push_back(value);
+  }
+  for (std::thread& t : producers) t.join();
+
+  int value = 0;
+  size_t pos = 0;
+  CHECK_FALSE(queue.pop(value, pos));
+  std::sort(seen.begin(), seen.end());
+  for (int i = 0; i < nthreads * count; i++) REQUIRE(seen[i] == i);
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("ring reports full and empty", "[ring]") {
+  hdaq::ring<int> queue(3);
+  size_t pos = 0;
+  for (int i = 0; i < 4; i++) REQUIRE(queue.push(i, pos));
+  CHECK_FALSE(queue.push(4, pos));
+  CHECK(queue.size() == 4);
+
+  int value = 0;
+  for (int i = 0; i < 4; i++) {
+    REQUIRE(queue.pop(value, pos));
+    CHECK(value == i);
+  }
+  CHECK_FALSE(queue.pop(value, pos));
+  CHECK(queue.size() == 0);
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("async blocking policy writes all records in order", "[async]") {
+  remove_files({"t_async_block.h5"});
+  const int count = 5000;
+  {
+    hdaq::async_interface io("t_async_block", 4, hdaq::backpressure::block);
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 2; t++) {
+      producers.emplace_back([&io, t]() {
+        insert_range<int>(io, "p" + std::to_string(t), 0, count);
+      });
+    }
+    for (std::thread& t : producers) t.join();
+    io.flush();
+    CHECK(io.dropped() == 0);
+    CHECK(io.high_water_mark() <= 4);
+  }
+  for (int t = 0; t < 2; t++) {
+    const std::vector<int> data =
+      read_all<int>("t_async_block.h5", "p" + std::to_string(t));
+    REQUIRE(data.size() == static_cast<size_t>(count));
+    for (int i = 0; i < count; i++) REQUIRE(data[i] == i);
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("async lossy policies account for every record", "[async]") {
+  remove_files({"t_async_drop.h5", "t_async_error.h5"});
+  const int count = 20000;
+
+  size_t dropped = 0;
+  {
+    hdaq::async_interface io("t_async_drop", 2, hdaq::backpressure::drop_oldest);
+    insert_range<int>(io, "x", 0, count);
+    io.flush();
+    dropped = io.dropped();
+  }
+  const std::vector<int> kept = read_all<int>("t_async_drop.h5", "x");
+  CHECK(kept.size() + dropped == static_cast<size_t>(count));
+  CHECK(dropped > 0);
+  CHECK(std::is_sorted(kept.begin(), kept.end()));
+  CHECK(kept.back() == count - 1);
+
+  size_t rejected = 0;
+  {
+    hdaq::async_interface io("t_async_error", 2, hdaq::backpressure::error);
+    for (int i = 0; i < count; i++) {
+      hdaq::dataset<int> rec(1);
+      rec[0] = i;
+      try {
+        io.insert(std::move(rec), "x");
+      } catch (const std::runtime_error&) {
+        rejected++;
+      }
+    }
+    io.flush();
+    CHECK(io.dropped() == 0);
+  }
+  const std::vector<int> written = read_all<int>("t_async_error.h5", "x");
+  CHECK(written.size() + rejected == static_cast<size_t>(count));
+  CHECK(rejected > 0);
+  CHECK(std::is_sorted(written.begin(), written.end()));
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("async flush rethrows writer errors", "[async]") {
+  remove_files({"t_async_fail.h5"});
+  hdaq::async_interface io("t_async_fail");
+  insert_range<int>(io, "x", 0, 2);
+
+  hdaq::attribute<int> attr("a", 1);
+  io.insert(attr, "x");
+  io.insert(attr, "x");
+  CHECK_THROWS_AS(io.flush(), H5::Exception);
+
+  io.insert(hdaq::dataset<int>(3), "x");
+  CHECK_THROWS_AS(io.flush(), std::runtime_error);
+
+  // errors are reported once; later records are written again
+  insert_range<int>(io, "x", 2, 4);
+  CHECK_NOTHROW(io.flush());
+}
@@ -0,0 +1,80 @@
+#include "common.hpp"
+
+#include <catch2/catch.hpp>
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("buffered records are written once the block is full", "[buffer]") {
+  remove_files({"t_buffer.h5"});
+  hdaq::interface io("t_buffer");
+  io.set_buffer("x", 4);
+
+  insert_range<int>(io, "x", 0, 3);
+  {
+    hdaq::reader file("t_buffer.h5");
+    CHECK(file.records("x") == 0);
+  }
+  insert_range<int>(io, "x", 3, 6);
+  {
+    hdaq::reader file("t_buffer.h5");
+    CHECK(file.records("x") == 4);
+  }
+  io.flush("x");
+  {
+    hdaq::reader file("t_buffer.h5");
+    CHECK(file.records("x") == 6);
+  }
+  insert_range<int>(io, "x", 6, 7);
+  io.flush();
+
+  hdaq::reader file("t_buffer.h5");
+  std::vector<int> data(7);
+  file.read("x", 0, 7, data.data());
+  for (int i = 0; i < 7; i++) CHECK(data[i] == i);
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("buffer limits and layouts", "[buffer]") {
+  remove_files({"t_buffer_layout.h5"});
+  {
+    hdaq::interface io("t_buffer_layout");
+    // the byte limit holds three records of two doubles
+    io.set_buffer(100, 3 * 2 * sizeof(double));
+    hdaq::dataset_options rm;
+    rm.layout = hdaq::layout::record_major;
+    for (int i = 0; i < 7; i++) {
+      io.insert(hdaq::dataset<double>({1.0 * i, -1.0 * i}), "cm");
+      io.insert(hdaq::dataset<double>({1.0 * i, -1.0 * i}), "rm", rm);
+    }
+    hdaq::reader file("t_buffer_layout.h5");
+    CHECK(file.records("cm") == 6);
+    CHECK(file.records("rm") == 6);
+  }
+
+  for (const char* name : {"cm", "rm"}) {
+    const std::vector<double> data = read_all<double>("t_buffer_layout.h5", name);
+    REQUIRE(data.size() == 14);
+    for (int i = 0; i < 7; i++) {
+      CHECK(data[2 * i] == i);
+      CHECK(data[2 * i + 1] == -i);
+    }
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("records of another type bypass the staging block", "[buffer]") {
+  remove_files({"t_buffer_type.h5"});
+  {
+    hdaq::interface io("t_buffer_type");
+    io.set_buffer("x", 8);
+    insert_range<double>(io, "x", 0, 3);
+    insert_range<float>(io, "x", 3, 5);
+    insert_range<double>(io, "x", 5, 6);
+    insert_range<int>(io, "x", 6, 8);
+  }
+  const std::vector<double> data = read_all<double>("t_buffer_type.h5", "x");
+  REQUIRE(data.size() == 8);
+  for (int i = 0; i < 8; i++) CHECK(data[i] == i);
+}
@@ -0,0 +1,127 @@
+#include "common.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* ------------------------------------------------------------------------- */
+
+/// Appends records behind the back of the interface, as a writer that
+/// crashed after its last checkpoint would have left them.
+static void append_uncheckpointed(
+  const std::string& fname,
+  const std::string& name,
+  const std::vector<int>& values
+) {
+  H5::H5File file(fname, H5F_ACC_RDWR);
+  H5::DataSet dset = file.openDataSet(name);
+  hsize_t dims[2];
+  hsize_t maxdims[2];
+  dset.getSpace().getSimpleExtentDims(dims, maxdims);
+
+  // records of a single element, along whichever axis is unlimited
+  const int axis = maxdims[0] == H5S_UNLIMITED? 0 : 1;
+  hsize_t offs[2] = {0, 0};
+  hsize_t count[2] = {1, 1};
+  hsize_t ndims[2] = {dims[0], dims[1]};
+  offs[axis] = dims[axis];
+  count[axis] = values.size();
+  ndims[axis] += values.size();
+  dset.extend(ndims);
+  H5::DataSpace fspace = dset.getSpace();
+  fspace.selectHyperslab(H5S_SELECT_SET, count, offs);
+  H5::DataSpace mspace(2, count);
+  dset.write(values.data(), H5::PredType::NATIVE_INT, mspace, fspace);
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("resume truncates to the last checkpoint", "[checkpoint]") {
+  remove_files({"t_ckpt.h5", "t_ckpt_scratch.h5"});
+  hdaq::checkpoint_options opts;
+  opts.records = 10;
+  {
+    hdaq::interface io("t_ckpt");
+    io.set_checkpoint(opts);
+    io.set_buffer("x", 4);
+    insert_range<int>(io, "x", 0, 25);
+  }
+  REQUIRE(read_all<int>("t_ckpt.h5", "x").size() == 25);
+
+  append_uncheckpointed("t_ckpt.h5", "x", {-1, -1, -1});
+  REQUIRE(read_all<int>("t_ckpt.h5", "x").size() == 28);
+
+  {
+    hdaq::interface io("t_ckpt_scratch");
+    io.set_checkpoint(opts);
+    io.set_filename("t_ckpt");
+    insert_range<int>(io, "x", 25, 30);
+  }
+  const std::vector<int> data = read_all<int>("t_ckpt.h5", "x");
+  REQUIRE(data.size() == 30);
+  for (int i = 0; i < 30; i++) REQUIRE(data[i] == i);
+
+  hdaq::reader file("t_ckpt.h5");
+  CHECK(file.read_attribute<uint64_t>("x", "hdaq_checkpoint")[0] == 30);
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("resume keeps files written without checkpoints", "[checkpoint]") {
+  remove_files({"t_nockpt.h5", "t_nockpt_scratch.h5"});
+  {
+    hdaq::interface io("t_nockpt");
+    insert_range<int>(io, "x", 0, 10);
+  }
+  append_uncheckpointed("t_nockpt.h5", "x", {10, 11});
+  {
+    hdaq::interface io("t_nockpt_scratch");
+    io.set_filename("t_nockpt");
+    insert_range<int>(io, "x", 12, 15);
+  }
+  const std::vector<int> data = read_all<int>("t_nockpt.h5", "x");
+  REQUIRE(data.size() == 15);
+  for (int i = 0; i < 15; i++) REQUIRE(data[i] == i);
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("a resumed file is checkpointed before new appends", "[checkpoint]") {
+  remove_files({"t_reckpt.h5", "t_reckpt_scratch.h5"});
+  {
+    hdaq::interface io("t_reckpt");
+    io.set_checkpoint(hdaq::checkpoint_options());
+    io.checkpoint();
+    insert_range<int>(io, "x", 0, 10);
+  }
+  append_uncheckpointed("t_reckpt.h5", "x", {-1, -1});
+
+  // resumed without a cadence, appended to and flushed, then killed
+  // before any further checkpoint
+  const pid_t pid = fork();
+  REQUIRE(pid >= 0);
+  if (pid == 0) {
+    hdaq::interface io("t_reckpt_scratch");
+    io.set_filename("t_reckpt");
+    insert_range<int>(io, "x", -5, 0);
+    io.flush();
+    _exit(0);
+  }
+  int status = 0;
+  REQUIRE(waitpid(pid, &status, 0) == pid);
+  REQUIRE(read_all<int>("t_reckpt.h5", "x").size() == 15);
+
+  {
+    hdaq::interface io("t_reckpt_scratch");
+    io.set_filename("t_reckpt");
+    insert_range<int>(io, "x", 10, 12);
+  }
+  const std::vector<int> data = read_all<int>("t_reckpt.h5", "x");
+  REQUIRE(data.size() == 12);
+  for (int i = 0; i < 12; i++) REQUIRE(data[i] == i);
+
+  // closed cleanly without a cadence, the checkpoint is still refreshed
+  hdaq::reader file("t_reckpt.h5");
+  CHECK(file.read_attribute<uint64_t>("x", "hdaq_checkpoint")[0] == 12);
+}
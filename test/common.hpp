@@ -0,0 +1,34 @@
+#ifndef HDAQ_TEST_COMMON_HPP
+#define HDAQ_TEST_COMMON_HPP
+
+#include <hdaq.hpp>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/// Removes files left over by a previous run.
+inline void remove_files(const std::vector<std::string>& names) {
+  for (const std::string& name : names) std::remove(name.c_str());
+}
+
+/// Reads every record of a dataset, record-major.
+template <typename T>
+std::vector<T> read_all(const std::string& fname, const std::string& name) {
+  hdaq::reader file(fname);
+  std::vector<T> buf(file.records(name) * file.size(name));
+  if (!buf.empty()) file.read(name, 0, file.records(name), buf.data());
+  return buf;
+}
+
+/// Inserts the single-element records `first, first + 1, ..., last - 1`.
+template <typename T, typename Interface>
+void insert_range(Interface& io, const std::string& name, int first, int last) {
+  for (int i = first; i < last; i++) {
+    hdaq::dataset<T> rec(1);
+    rec[0] = static_cast<T>(i);
+    io.insert(rec, name);
+  }
+}
+
+#endif
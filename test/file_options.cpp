@@ -0,0 +1,93 @@
+#include "common.hpp"
+
+#include <catch2/catch.hpp>
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("aligned files place chunks on the alignment", "[file_options]") {
+  remove_files({"t_aligned.h5"});
+  hdaq::file_options fopts;
+  fopts.alignment = 4096;
+  fopts.alignment_threshold = 1;
+  fopts.meta_block = 8192;
+  {
+    hdaq::interface io("t_aligned", fopts);
+    hdaq::dataset_options opts;
+    opts.chunk_records = 16;
+    io.create_dataset<int>("a", 1, opts);
+    io.create_dataset<int>("b", 1, opts);
+    for (int i = 0; i < 40; i++) {
+      io.insert(hdaq::dataset<int>({i}), "a");
+      io.insert(hdaq::dataset<int>({-i}), "b");
+    }
+  }
+
+  hdaq::reader file("t_aligned.h5");
+  for (const char* name : {"a", "b"}) {
+    for (hsize_t c = 0; c < 3; c++) {
+      const hsize_t offs[2] = {0, 16 * c};
+      unsigned mask = 0;
+      haddr_t addr = 0;
+      hsize_t bytes = 0;
+      REQUIRE(H5Dget_chunk_info_by_coord(
+        file.dataset(name).getId(), offs, &mask, &addr, &bytes
+      ) >= 0);
+      CHECK(addr % 4096 == 0);
+    }
+  }
+  CHECK(read_all<int>("t_aligned.h5", "a").back() == 39);
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("paged files keep their page size", "[file_options]") {
+  remove_files({"t_paged.h5"});
+  hdaq::file_options fopts;
+  fopts.page_size = 8192;
+  fopts.page_buffer = 4 * 8192;
+  {
+    hdaq::interface io("t_paged", fopts);
+    insert_range<float>(io, "x", 0, 100);
+  }
+
+  H5::H5File h5("t_paged.h5", H5F_ACC_RDONLY);
+  hsize_t page = 0;
+  REQUIRE(H5Pget_file_space_page_size(h5.getCreatePlist().getId(), &page) >= 0);
+  CHECK(page == 8192);
+  h5.close();
+
+  const std::vector<float> data = read_all<float>("t_paged.h5", "x");
+  REQUIRE(data.size() == 100);
+  for (int i = 0; i < 100; i++) CHECK(data[i] == i);
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("core driver files are stored and resumed", "[file_options]") {
+  remove_files({"t_core.h5"});
+  hdaq::file_options fopts;
+  fopts.driver = hdaq::driver::core;
+  fopts.core_increment = 1024 * 1024;
+  {
+    hdaq::interface io("t_core", fopts);
+    insert_range<int>(io, "x", 0, 5);
+  }
+  CHECK(read_all<int>("t_core.h5", "x").size() == 5);
+
+  {
+    hdaq::interface io;
+    io.set_filename("t_core", fopts);
+    insert_range<int>(io, "x", 5, 8);
+  }
+  CHECK(read_all<int>("t_core.h5", "x") ==
+        std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7}));
+
+  // without a backing store nothing reaches the disk
+  remove_files({"t_core_mem.h5"});
+  fopts.core_backing_store = false;
+  {
+    hdaq::interface io("t_core_mem", fopts);
+    insert_range<int>(io, "x", 0, 5);
+  }
+  CHECK_FALSE(std::ifstream("t_core_mem.h5").is_open());
+}
@@ -0,0 +1,56 @@
+#include "common.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("datasets are created in nested groups", "[handle]") {
+  remove_files({"t_groups.h5"});
+  {
+    hdaq::interface io("t_groups");
+    hdaq::handle<int> h = io.create_dataset<int>("a/b/c", 2);
+    CHECK(h.valid());
+    io.insert(hdaq::dataset<int>({1, 2}), h);
+    io.insert(hdaq::dataset<int>({3, 4}), "/a/b/c");
+    io.insert(hdaq::dataset<int>({5}), "a/d");
+  }
+
+  hdaq::reader file("t_groups.h5");
+  const std::vector<std::string> names = file.datasets();
+  CHECK(std::find(names.begin(), names.end(), "/a/b/c") != names.end());
+  CHECK(std::find(names.begin(), names.end(), "/a/d") != names.end());
+  CHECK(read_all<int>("t_groups.h5", "a/b/c") == std::vector<int>({1, 2, 3, 4}));
+  CHECK(read_all<int>("t_groups.h5", "/a/d") == std::vector<int>({5}));
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("handles expire when the file changes", "[handle]") {
+  remove_files({"t_handle_a.h5", "t_handle_b.h5"});
+  hdaq::interface io("t_handle_a");
+  hdaq::handle<double> h = io.create_dataset<double>("g/x", 1);
+  io.insert(hdaq::dataset<double>({1.0}), h);
+
+  CHECK_THROWS_AS(io.open_dataset<int>("g/x"), std::runtime_error);
+  CHECK_THROWS_AS(io.open_dataset<double>("g/missing"), std::runtime_error);
+  CHECK_THROWS_AS(
+    io.insert(hdaq::dataset<double>({0.0}), hdaq::handle<double>()),
+    std::runtime_error
+  );
+
+  io.set_filename("t_handle_b");
+  CHECK_FALSE(h.valid());
+  CHECK_THROWS_AS(io.insert(hdaq::dataset<double>({2.0}), h), std::runtime_error);
+
+  // resuming the first file rediscovers the dataset under the same path
+  io.set_filename("t_handle_a");
+  CHECK_FALSE(h.valid());
+  h = io.open_dataset<double>("/g/x");
+  CHECK(h.valid());
+  io.insert(hdaq::dataset<double>({3.0}), h);
+  io.flush();
+
+  CHECK(read_all<double>("t_handle_a.h5", "g/x") == std::vector<double>({1.0, 3.0}));
+}
@@ -0,0 +1,70 @@
+#include "common.hpp"
+
+#include <catch2/catch.hpp>
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("chunk and filter options reach the dataset", "[options]") {
+  remove_files({"t_opts.h5"});
+  {
+    hdaq::interface io("t_opts");
+    hdaq::dataset_options opts;
+    opts.layout = hdaq::layout::record_major;
+    opts.chunk_records = 16;
+    opts.shuffle = true;
+    opts.deflate = 4;
+    io.create_dataset<float>("explicit", 8, opts);
+
+    io.create_dataset<double>("derived", 4);
+
+    hdaq::dataset_options small;
+    small.expected_records = 10;
+    io.create_dataset<double>("small", 4, small);
+  }
+
+  hdaq::reader file("t_opts.h5");
+  CHECK(file.layout("explicit") == hdaq::layout::record_major);
+  CHECK(file.layout("derived") == hdaq::layout::channel_major);
+  CHECK(file.chunk_records("explicit") == 16);
+  CHECK(file.chunk_records("derived") == 512 * 1024 / (4 * sizeof(double)));
+  CHECK(file.chunk_records("small") == 10);
+
+  const H5::DSetCreatPropList plist =
+    file.dataset("explicit").getCreatePlist();
+  REQUIRE(plist.getNfilters() == 2);
+  unsigned int flags = 0;
+  size_t nvalues = 1;
+  unsigned int level = 0;
+  unsigned int config = 0;
+  char name[32];
+  CHECK(plist.getFilter(0, flags, nvalues, &level, 0, name, config) ==
+        H5Z_FILTER_SHUFFLE);
+  nvalues = 1;
+  CHECK(plist.getFilter(1, flags, nvalues, &level, sizeof(name), name, config) ==
+        H5Z_FILTER_DEFLATE);
+  CHECK(level == 4);
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("reduction companions use chunks divided by the factor", "[options]") {
+  remove_files({"t_opts_red.h5"});
+  {
+    hdaq::interface io("t_opts_red");
+    hdaq::reduction_options red;
+    red.decimate = 4;
+    red.levels = {8, 64};
+    io.set_reduction("x", red);
+    hdaq::dataset_options opts;
+    opts.chunk_records = 128;
+    opts.deflate = 1;
+    io.create_dataset<double>("x", 2, opts);
+  }
+
+  hdaq::reader file("t_opts_red.h5");
+  CHECK(file.chunk_records("x") == 128);
+  CHECK(file.chunk_records("x_every_4") == 32);
+  CHECK(file.chunk_records("x_min_8") == 16);
+  CHECK(file.chunk_records("x_rms_64") == 2);
+  CHECK(file.dataset("x_mean_8").getCreatePlist().getNfilters() == 1);
+}
@@ -0,0 +1,103 @@
+#include "common.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+
+/* ------------------------------------------------------------------------- */
+
+/// Writes `nrec` records of `size` elements, element `i` of record `r`
+/// holding `1000 * r + i`.
+static void write_grid(
+  const std::string& fname,
+  const size_t nrec,
+  const size_t size,
+  const hdaq::dataset_options& opts
+) {
+  hdaq::interface io(fname);
+  for (size_t r = 0; r < nrec; r++) {
+    hdaq::dataset<int> rec(size);
+    for (size_t i = 0; i < size; i++) rec[i] = static_cast<int>(1000 * r + i);
+    io.insert(rec, "grid", opts);
+  }
+  io.insert(hdaq::attribute<double>("scale", {0.5, 2.0}), "grid");
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("reader slices records and elements in both layouts", "[reader]") {
+  for (const hdaq::layout layout :
+       {hdaq::layout::channel_major, hdaq::layout::record_major}) {
+    remove_files({"t_reader.h5"});
+    hdaq::dataset_options opts;
+    opts.layout = layout;
+    opts.chunk_records = 4;
+    write_grid("t_reader", 10, 6, opts);
+
+    hdaq::reader file("t_reader.h5");
+    CHECK(file.records("grid") == 10);
+    CHECK(file.size("grid") == 6);
+    CHECK(file.layout("grid") == layout);
+    CHECK(file.chunk_records("grid") == 4);
+
+    const std::vector<std::string> attrs = file.attributes("grid");
+    CHECK(std::find(attrs.begin(), attrs.end(), "scale") != attrs.end());
+    CHECK(file.read_attribute<double>("grid", "scale")[1] == 2.0);
+
+    // records are returned record-major whatever the layout in the file
+    std::vector<int> recs(3 * 6);
+    file.read("grid", 2, 3, recs.data());
+    for (size_t r = 0; r < 3; r++) {
+      for (size_t i = 0; i < 6; i++) {
+        CHECK(recs[6 * r + i] == static_cast<int>(1000 * (r + 2) + i));
+      }
+    }
+
+    std::vector<double> elems(4 * 2);
+    file.read("grid", 5, 4, 3, 2, elems.data());
+    for (size_t r = 0; r < 4; r++) {
+      CHECK(elems[2 * r] == 1000 * (r + 5) + 3);
+      CHECK(elems[2 * r + 1] == 1000 * (r + 5) + 4);
+    }
+
+    CHECK_THROWS(file.records("missing"));
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("stream returns chunk-aligned batches", "[reader]") {
+  remove_files({"t_stream.h5"});
+  hdaq::dataset_options opts;
+  opts.chunk_records = 4;
+  write_grid("t_stream", 10, 3, opts);
+
+  hdaq::reader file("t_stream.h5");
+  // five records per batch round up to two chunks
+  hdaq::stream<int> s(file, "grid", 5);
+  std::vector<size_t> firsts;
+  std::vector<size_t> counts;
+  size_t expected = 0;
+  for (const hdaq::stream<int>::batch& b : s) {
+    firsts.push_back(b.first);
+    counts.push_back(b.count);
+    CHECK(b.size == 3);
+    for (size_t r = 0; r < b.count; r++) {
+      for (size_t i = 0; i < 3; i++) {
+        CHECK(b.data[3 * r + i] == static_cast<int>(1000 * expected + i));
+      }
+      expected++;
+    }
+  }
+  CHECK(firsts == std::vector<size_t>({0, 8}));
+  CHECK(counts == std::vector<size_t>({8, 2}));
+  CHECK(expected == 10);
+
+  hdaq::stream<int> single(file, "grid");
+  size_t batches = 0;
+  while (single.next()) {
+    CHECK(single.current().count <= 4);
+    batches++;
+  }
+  CHECK(batches == 3);
+}
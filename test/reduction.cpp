@@ -0,0 +1,98 @@
+#include "common.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <complex>
+
+/* ------------------------------------------------------------------------- */
+
+/// Checks the overviews of a file holding the raw records `first..last-1`
+/// of a dataset reduced with `decimate = 3` and `levels = {4}`.
+static void check_overviews(const std::string& fname, int first, int last) {
+  const std::vector<double> raw = read_all<double>(fname, "x");
+  REQUIRE(raw.size() == static_cast<size_t>(last - first));
+  for (int i = first; i < last; i++) REQUIRE(raw[i - first] == i);
+
+  const std::vector<double> every = read_all<double>(fname, "x_every_3");
+  REQUIRE(every.size() == static_cast<size_t>((last - first + 2) / 3));
+  for (size_t k = 0; k < every.size(); k++) CHECK(every[k] == first + 3 * k);
+
+  // record k of a level covers the records [4k, 4k + 4) of the file
+  const std::vector<double> mn = read_all<double>(fname, "x_min_4");
+  const std::vector<double> mx = read_all<double>(fname, "x_max_4");
+  const std::vector<double> mean = read_all<double>(fname, "x_mean_4");
+  REQUIRE(mn.size() == static_cast<size_t>((last - first) / 4));
+  REQUIRE(mx.size() == mn.size());
+  REQUIRE(mean.size() == mn.size());
+  for (size_t k = 0; k < mn.size(); k++) {
+    CHECK(mn[k] == first + 4 * k);
+    CHECK(mx[k] == first + 4 * k + 3);
+    CHECK(mean[k] == Approx(first + 4 * k + 1.5));
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("overview blocks stay aligned across a resume", "[reduction]") {
+  remove_files({"t_red_resume.h5", "t_red_scratch.h5"});
+  hdaq::reduction_options opts;
+  opts.decimate = 3;
+  opts.levels = {4};
+  {
+    hdaq::interface io("t_red_resume");
+    io.set_reduction("x", opts);
+    insert_range<double>(io, "x", 0, 10);
+  }
+  check_overviews("t_red_resume.h5", 0, 10);
+  {
+    hdaq::interface io("t_red_scratch");
+    io.set_reduction("x", opts);
+    io.set_filename("t_red_resume");
+    insert_range<double>(io, "x", 10, 23);
+  }
+  check_overviews("t_red_resume.h5", 0, 23);
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("overview blocks restart in every rolled file", "[reduction]") {
+  const std::vector<std::string> names = {
+    "t_red_roll.h5", "t_red_roll_000001.h5", "t_red_roll_000002.h5",
+    "t_red_roll_000003.h5"
+  };
+  remove_files(names);
+  {
+    hdaq::interface io("t_red_roll");
+    hdaq::reduction_options opts;
+    opts.decimate = 3;
+    opts.levels = {4};
+    io.set_reduction("x", opts);
+    hdaq::rollover_options roll;
+    roll.max_records = 10;
+    io.set_rollover(roll);
+    insert_range<double>(io, "x", 0, 25);
+  }
+  check_overviews(names[0], 0, 10);
+  check_overviews(names[1], 10, 20);
+  check_overviews(names[2], 20, 25);
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("levels on non-arithmetic records create no dataset", "[reduction]") {
+  remove_files({"t_red_type.h5"});
+  {
+    hdaq::interface io("t_red_type");
+    hdaq::reduction_options opts;
+    opts.decimate = 3;
+    opts.levels = {4};
+    io.set_reduction("x", opts);
+
+    hdaq::dataset<std::complex<double>> rec(1);
+    CHECK_THROWS_AS(io.insert(rec, "x"), std::runtime_error);
+    CHECK_THROWS_AS(io.open_dataset<std::complex<double>>("x"), std::runtime_error);
+
+    insert_range<double>(io, "x", 0, 8);
+  }
+  check_overviews("t_red_type.h5", 0, 8);
+}
@@ -0,0 +1,78 @@
+#include "common.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <ctime>
+#include <fstream>
+#include <thread>
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("rollover numbers files and replicates attributes", "[rollover]") {
+  const std::vector<std::string> names = {
+    "t_roll.h5", "t_roll_000001.h5", "t_roll_000002.h5", "t_roll_000003.h5"
+  };
+  remove_files(names);
+  {
+    hdaq::interface io("t_roll");
+    insert_range<int>(io, "run/x", 0, 1);
+    io.insert(hdaq::attribute<int>("gain", {3}), "run/x");
+    hdaq::rollover_options roll;
+    roll.max_records = 4;
+    io.set_rollover(roll);
+    insert_range<int>(io, "run/x", 1, 10);
+    CHECK(io.filename() == "t_roll_000002.h5");
+  }
+
+  // the record written before the limit was set is not counted
+  CHECK(read_all<int>(names[0], "run/x") == std::vector<int>({0, 1, 2, 3, 4}));
+  CHECK(read_all<int>(names[1], "run/x") == std::vector<int>({5, 6, 7, 8}));
+  CHECK(read_all<int>(names[2], "run/x") == std::vector<int>({9}));
+  CHECK_FALSE(std::ifstream(names[3]).is_open());
+  for (size_t i = 0; i < 3; i++) {
+    hdaq::reader file(names[i]);
+    CHECK(file.read_attribute<int>("run/x", "gain")[0] == 3);
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("rollover requires a file name", "[rollover]") {
+  remove_files({".h5"});
+  hdaq::interface io;
+  hdaq::rollover_options roll;
+  roll.max_records = 4;
+  CHECK_THROWS_AS(io.set_rollover(roll), std::runtime_error);
+  CHECK_NOTHROW(io.set_rollover(hdaq::rollover_options()));
+  remove_files({".h5"});
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("timestamp names are taken at the switch", "[rollover]") {
+  remove_files({"t_stamp.h5"});
+  std::string name;
+  std::time_t before = 0;
+  {
+    hdaq::interface io("t_stamp");
+    hdaq::rollover_options roll;
+    roll.max_records = 4;
+    roll.prepare_at = 0.25;
+    roll.naming = hdaq::naming::timestamp;
+    io.set_rollover(roll);
+    insert_range<int>(io, "x", 0, 2);
+
+    // the next file is prepared by now; switch a few seconds later
+    std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+    before = std::time(nullptr);
+    insert_range<int>(io, "x", 2, 5);
+    name = io.filename();
+  }
+
+  char stamp[32];
+  std::strftime(stamp, sizeof(stamp), "%Y%m%dT%H%M%S", std::gmtime(&before));
+  REQUIRE(name.size() == std::string("t_stamp_").size() + 15 + 3);
+  CHECK(name.substr(8, 15) >= std::string(stamp));
+  CHECK(read_all<int>(name, "x") == std::vector<int>({4}));
+  remove_files({name});
+}
@@ -0,0 +1,61 @@
+#include "common.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <fstream>
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("shard names follow the rank", "[shard]") {
+  CHECK(hdaq::shard_name("run", 0) == "run_shard0000");
+  CHECK(hdaq::shard_name("run", 12) == "run_shard0012");
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("merge concatenates shards and keeps empty datasets", "[shard]") {
+  const std::vector<std::string> shards = {
+    "t_merge_shard0000.h5", "t_merge_shard0001.h5", "t_merge_shard0002.h5"
+  };
+  remove_files(shards);
+  remove_files({"t_merge.h5"});
+
+  hdaq::dataset_options rm;
+  rm.layout = hdaq::layout::record_major;
+  for (size_t i = 0; i < shards.size(); i++) {
+    hdaq::interface io(hdaq::shard_name("t_merge", i));
+    io.create_dataset<int>("x", 1);
+    io.create_dataset<double>("empty", 3, rm);
+    // the middle shard holds no record of x
+    if (i != 1) insert_range<int>(io, "x", 10 * i, 10 * i + 5);
+    if (i == 0) io.insert(hdaq::attribute<int>("run", {7}), "x");
+  }
+
+  hdaq::merge_shards("t_merge.h5", shards);
+  CHECK_FALSE(std::ifstream("t_merge.h5.tmp").is_open());
+
+  const std::vector<int> data = read_all<int>("t_merge.h5", "x");
+  const std::vector<int> expected = {0, 1, 2, 3, 4, 20, 21, 22, 23, 24};
+  CHECK(data == expected);
+
+  hdaq::reader file("t_merge.h5");
+  CHECK(file.read_attribute<int>("x", "run")[0] == 7);
+  CHECK(file.records("empty") == 0);
+  CHECK(file.size("empty") == 3);
+  CHECK(file.layout("empty") == hdaq::layout::record_major);
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("a failed merge leaves the previous master", "[shard]") {
+  remove_files({"t_mismatch_a.h5", "t_mismatch_b.h5", "t_mismatch.h5"});
+  { hdaq::interface io("t_mismatch_a"); insert_range<int>(io, "x", 0, 2); }
+  { hdaq::interface io("t_mismatch_b"); insert_range<double>(io, "x", 0, 2); }
+  { hdaq::interface io("t_mismatch"); insert_range<int>(io, "old", 0, 1); }
+
+  CHECK_THROWS_AS(
+    hdaq::merge_shards("t_mismatch.h5", {"t_mismatch_a.h5", "t_mismatch_b.h5"}),
+    std::runtime_error
+  );
+  CHECK(read_all<int>("t_mismatch.h5", "old").size() == 1);
+}
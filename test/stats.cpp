@@ -0,0 +1,71 @@
+#include "common.hpp"
+
+#include <catch2/catch.hpp>
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("stats count records, extensions and flushes", "[stats]") {
+  remove_files({"t_stats.h5"});
+  hdaq::interface io("t_stats");
+  size_t reports = 0;
+  io.set_stats_sink(
+    [&reports](const hdaq::stats_report&) { reports++; },
+    std::chrono::milliseconds(0)
+  );
+
+  hdaq::dataset_options opts;
+  opts.chunk_records = 4;
+  io.set_buffer("buffered", 4);
+  io.create_dataset<double>("direct", 1, opts);
+  io.create_dataset<double>("buffered", 1, opts);
+  insert_range<double>(io, "direct", 0, 6);
+  insert_range<double>(io, "buffered", 0, 10);
+  io.flush();
+
+  const hdaq::stats_report report = io.stats();
+  REQUIRE(report.datasets.count("/direct") == 1);
+  REQUIRE(report.datasets.count("/buffered") == 1);
+  const hdaq::dataset_stats& direct = report.datasets.at("/direct");
+  const hdaq::dataset_stats& buffered = report.datasets.at("/buffered");
+  CHECK(report.errors == 0);
+
+#ifdef HDAQ_ENABLE_STATS
+  CHECK(direct.records == 6);
+  CHECK(direct.bytes == 6 * sizeof(double));
+  CHECK(direct.extends == 6);
+  CHECK(direct.flushes == 0);
+  CHECK(direct.chunks == 6);
+  CHECK(direct.write.count == 6);
+
+  // two full blocks then the remainder on flush
+  CHECK(buffered.records == 10);
+  CHECK(buffered.extends == 3);
+  CHECK(buffered.flushes == 3);
+  CHECK(buffered.chunks == 3);
+  CHECK(buffered.partial_chunks == 1);
+  CHECK(buffered.stage.count == 10);
+
+  CHECK(reports == 16);
+#else
+  CHECK(direct.records == 0);
+  CHECK(direct.extends == 0);
+  CHECK(buffered.flushes == 0);
+  CHECK(buffered.stage.count == 0);
+  CHECK(reports == 0);
+#endif
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("chunk accounting of partial writes", "[stats]") {
+  hdaq::dataset_stats s;
+  s.written(0, 4, 4);
+  CHECK(s.chunks == 1);
+  CHECK(s.partial_chunks == 0);
+  s.written(5, 2, 4);
+  CHECK(s.chunks == 2);
+  CHECK(s.partial_chunks == 1);
+  s.written(6, 5, 4);
+  CHECK(s.chunks == 4);
+  CHECK(s.partial_chunks == 3);
+}
@@ -0,0 +1,74 @@
+#include "common.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* ------------------------------------------------------------------------- */
+
+/// Writes one byte to a pipe and waits for the peer's, so that the writer
+/// and the reader processes take turns.
+static bool handshake(const int out, const int in) {
+  char c = 0;
+  return write(out, &c, 1) == 1 && read(in, &c, 1) == 1;
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("tail polls the records of a live SWMR writer", "[swmr]") {
+  remove_files({"t_swmr.h5"});
+  int to_reader[2];
+  int to_writer[2];
+  REQUIRE(pipe(to_reader) == 0);
+  REQUIRE(pipe(to_writer) == 0);
+
+  const pid_t pid = fork();
+  REQUIRE(pid >= 0);
+  if (pid == 0) {
+    bool ok = false;
+    try {
+      hdaq::file_options fopts;
+      fopts.latest_format = true;
+      hdaq::interface io("t_swmr", fopts);
+      hdaq::dataset_options opts;
+      opts.chunk_records = 4;
+      io.create_dataset<int>("x", 1, opts);
+      io.set_buffer("x", 16);
+      io.start_swmr(hdaq::swmr_options{1, std::chrono::milliseconds(0)});
+      insert_range<int>(io, "x", 0, 3);
+      ok = handshake(to_reader[1], to_writer[0]);
+      insert_range<int>(io, "x", 3, 8);
+      ok = ok && handshake(to_reader[1], to_writer[0]);
+    } catch (...) {
+      ok = false;
+    }
+    _exit(ok? 0 : 1);
+  }
+
+  char c = 0;
+  REQUIRE(read(to_reader[0], &c, 1) == 1);
+  hdaq::reader file("t_swmr.h5", true);
+  hdaq::tail live(file, "x");
+  std::vector<int> out;
+  CHECK(live.poll(out) == 3);
+  CHECK(out == std::vector<int>({0, 1, 2}));
+  CHECK(live.poll(out) == 0);
+  CHECK(out.empty());
+
+  REQUIRE(handshake(to_writer[1], to_reader[0]));
+  CHECK(live.poll(out, 2) == 2);
+  CHECK(out == std::vector<int>({3, 4}));
+  CHECK(live.poll(out) == 3);
+  CHECK(out == std::vector<int>({5, 6, 7}));
+  CHECK(live.position() == 8);
+
+  REQUIRE(write(to_writer[1], &c, 1) == 1);
+  int status = 0;
+  REQUIRE(waitpid(pid, &status, 0) == pid);
+  CHECK(WIFEXITED(status));
+  CHECK(WEXITSTATUS(status) == 0);
+  for (const int fd : {to_reader[0], to_reader[1], to_writer[0], to_writer[1]}) {
+    close(fd);
+  }
+}
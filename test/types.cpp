@@ -0,0 +1,113 @@
+#include "common.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <complex>
+
+/* ------------------------------------------------------------------------- */
+
+namespace {
+  struct event {
+    double time;
+    int16_t adc[4];
+    uint8_t flags;
+  };
+
+  enum class state : uint8_t { idle = 0, armed = 1, fired = 2 };
+  enum class mode : int { slow = 3, fast = 7 };
+}
+
+template <>
+struct hdaq::h5type<event> : hdaq::compound_type<event> {
+  static void describe(hdaq::compound<event>& c) {
+    c.insert("time", &event::time)
+     .insert("adc", &event::adc)
+     .insert("flags", &event::flags);
+  }
+};
+
+template <>
+struct hdaq::h5type<state> {
+  static const H5::DataType& get() {
+    static const hdaq::enumeration<state> type = hdaq::enumeration<state>()
+      .insert("idle", state::idle)
+      .insert("armed", state::armed)
+      .insert("fired", state::fired);
+    return type.type();
+  }
+};
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("compound records round trip", "[types]") {
+  remove_files({"t_compound.h5"});
+  {
+    hdaq::interface io("t_compound");
+    hdaq::dataset<event> events(2);
+    for (int r = 0; r < 3; r++) {
+      for (int k = 0; k < 2; k++) {
+        events[k].time = r + 0.5 * k;
+        for (int i = 0; i < 4; i++) events[k].adc[i] = 10 * r + i;
+        events[k].flags = static_cast<uint8_t>(k);
+      }
+      io.insert(events, "events");
+    }
+  }
+
+  hdaq::reader file("t_compound.h5");
+  CHECK(file.dataset("events").getDataType().getClass() == H5T_COMPOUND);
+  std::vector<event> data(3 * 2);
+  file.read("events", 0, 3, data.data());
+  for (int r = 0; r < 3; r++) {
+    for (int k = 0; k < 2; k++) {
+      const event& e = data[2 * r + k];
+      CHECK(e.time == r + 0.5 * k);
+      CHECK(e.adc[3] == 10 * r + 3);
+      CHECK(e.flags == k);
+    }
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("enums, strings, complex and arrays round trip", "[types]") {
+  remove_files({"t_types.h5"});
+  {
+    hdaq::interface io("t_types");
+    io.insert(hdaq::dataset<state>({state::idle, state::fired}), "state");
+    io.insert(hdaq::dataset<mode>({mode::fast, mode::slow}), "mode");
+    io.insert(hdaq::dataset<hdaq::fixed_string<8>>({"alpha", "a long name"}), "names");
+    io.insert(hdaq::dataset<std::complex<float>>({{1.f, -1.f}, {0.f, 2.f}}), "iq");
+    io.insert(hdaq::dataset<std::array<int, 3>>({{{1, 2, 3}}, {{4, 5, 6}}}), "xyz");
+  }
+
+  hdaq::reader file("t_types.h5");
+  CHECK(file.dataset("state").getDataType().getClass() == H5T_ENUM);
+  CHECK(file.dataset("mode").getDataType().getClass() == H5T_INTEGER);
+  CHECK(file.dataset("names").getDataType().getClass() == H5T_STRING);
+  CHECK(file.dataset("iq").getDataType().getClass() == H5T_COMPOUND);
+  CHECK(file.dataset("xyz").getDataType().getClass() == H5T_ARRAY);
+
+  std::vector<state> states(2);
+  file.read("state", 0, 1, states.data());
+  CHECK(states == std::vector<state>({state::idle, state::fired}));
+
+  std::vector<mode> modes(2);
+  file.read("mode", 0, 1, modes.data());
+  CHECK(modes == std::vector<mode>({mode::fast, mode::slow}));
+
+  std::vector<hdaq::fixed_string<8>> names(2);
+  file.read("names", 0, 1, names.data());
+  CHECK(names[0].str() == "alpha");
+  CHECK(names[1].str() == "a long n");
+
+  std::vector<std::complex<float>> iq(2);
+  file.read("iq", 0, 1, iq.data());
+  CHECK(iq[0] == std::complex<float>(1.f, -1.f));
+  CHECK(iq[1] == std::complex<float>(0.f, 2.f));
+
+  std::vector<std::array<int, 3>> xyz(2);
+  file.read("xyz", 0, 1, xyz.data());
+  CHECK(xyz[1][2] == 6);
+}
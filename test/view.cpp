@@ -0,0 +1,45 @@
+#include "common.hpp"
+
+#include <catch2/catch.hpp>
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("strided views are written in both layouts", "[view]") {
+  remove_files({"t_view.h5"});
+  // interleaved channels a0 b0 a1 b1 ..., one record per frame
+  std::vector<int> frame(8);
+  {
+    hdaq::interface io("t_view");
+    hdaq::dataset_options rm;
+    rm.layout = hdaq::layout::record_major;
+    io.set_buffer("buffered", 2);
+    for (int r = 0; r < 3; r++) {
+      for (int i = 0; i < 8; i++) frame[i] = 100 * r + i;
+      const hdaq::view<int> odd(frame.data() + 1, 4, 2);
+      io.insert(odd, "cm");
+      io.insert(odd, "rm", rm);
+      io.insert(odd, "buffered");
+      io.insert(hdaq::view<int>(frame), "whole");
+    }
+  }
+
+  for (const char* name : {"cm", "rm", "buffered"}) {
+    const std::vector<int> data = read_all<int>("t_view.h5", name);
+    REQUIRE(data.size() == 12);
+    for (int r = 0; r < 3; r++) {
+      for (int i = 0; i < 4; i++) CHECK(data[4 * r + i] == 100 * r + 2 * i + 1);
+    }
+  }
+  CHECK(read_all<int>("t_view.h5", "whole").size() == 24);
+}
+
+/* ------------------------------------------------------------------------- */
+
+TEST_CASE("containers take over vector storage", "[view]") {
+  std::vector<double> samples = {1.0, 2.0, 3.0};
+  const double* storage = samples.data();
+  hdaq::dataset<double> data(std::move(samples));
+  CHECK(data.size() == 3);
+  CHECK(data.data() == storage);
+  CHECK(data[2] == 3.0);
+}